@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////
+// Demonstrates the implementation of a Rolling Median.
+// Data is added in a circular buffer fashion.
+// A median is available after every reading.
+// The rolling median does not change the order of the buffer.
+// Uses an int16_t data type but any int or floating point type can be used.
+/////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "VectorStats.h"
+
+const unsigned long BAUD_RATE = 115200;
+const int sensor_pin = A0;  // Connect a sensor to pin A0.
+unsigned long start_time;
+
+// Create a buffer of type <int16_t> with max_buffer_size of 4095:
+VectorStats<int16_t> median_buffer(4095);
+
+
+
+// A function to generate random ints from 0 - 4095:
+int16_t randomInt() {
+    int16_t random_number = random(0, 4095);
+    return random_number;
+}
+
+
+void setup() {
+    Serial.begin(BAUD_RATE);
+    pinMode(sensor_pin, INPUT);
+    while(!Serial.available()) {
+        Serial.println("Press any key to begin...");
+        delay(1000);
+    }
+
+    // Fill buffer with the first reading and then start tracking the median.
+    // median_buffer.fillBuffer(analogRead(sensor_pin));
+    median_buffer.fillBuffer(randomInt());
+    median_buffer.setRollingMedian(true);
+    start_time = millis();
+}
+
+
+
+void loop() {
+    // Add a new reading to the buffer:
+    // median_buffer.add(analogRead(sensor_pin));
+    median_buffer.add(randomInt());
+
+    // The median is O(1) so it can be read after every add:
+    int16_t median = median_buffer.getMedian();
+
+    // Print the median every 1000 milliseconds (1 second):
+    if (millis() - start_time >= 1000) {
+        start_time = millis();
+        Serial.print("Median: ");
+        Serial.print(median);
+        Serial.print("   Element 0: ");
+        Serial.println(median_buffer.getElement(0));  // Order is still intact.
+    }
+
+}
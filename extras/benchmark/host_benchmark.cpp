@@ -0,0 +1,211 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Host benchmark for VectorStats. Runs on Linux, macOS or Windows instead of an ESP32.
+// Covers the same operations as examples/speedtests across buffer sizes from 15 to 1M and the
+// data types of data_types_speedtest.cpp, on synthetic ADC-like data.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -march=native -Isrc extras/benchmark/host_benchmark.cpp -o host_benchmark
+//   ./host_benchmark > results.jsonl
+//
+// Options:
+//   --csv            Print CSV instead of one JSON object per line.
+//   --quick          Stop at 65535 elements.
+//   --min-ms N       Time each case for at least N milliseconds. Default = 50.
+//   --data adc|ramp  Data generator. Default = adc.
+//
+// Every result has ns_per_op, items_per_s (buffer elements processed per second) and the heap
+// allocations and bytes per op, counted by the replaced global operator new.
+// getMedian() and getSortedElement() reorder the buffer, so they are timed one call at a time
+// on a freshly reloaded buffer. The reload is not timed.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+static unsigned long long allocations = 0;
+static unsigned long long allocated_bytes = 0;
+
+void* operator new(std::size_t size) {
+    allocations++;
+    allocated_bytes += size;
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+// Keeps results alive so the compiler cannot drop the work.
+template <typename V>
+inline void keep(V value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile V sink;
+    sink = value;
+#endif
+}
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    bool csv = false;
+    bool quick = false;
+    double min_ns = 50e6;
+    std::string data = "adc";
+};
+
+struct Result {
+    double ns = 0;
+    unsigned long long ops = 0;
+    unsigned long long allocations = 0;
+    unsigned long long bytes = 0;
+};
+
+// 12 bit readings: a slow sine drift, white noise and an occasional spike, like a noisy analogRead().
+// ramp is a repeating sawtooth that is already close to sorted.
+static std::vector<double> makeData(const std::string& kind, int size) {
+    std::vector<double> values(size);
+    unsigned int state = 12345;
+    for (int i = 0; i < size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        if (kind == "ramp") {
+            values[i] = i % 4096;
+            continue;
+        }
+        double noise = ((state >> 8) % 201) - 100.0;
+        double spike = (state >> 28) == 0 && (state & 0xFF) < 16 ? 1500.0 : 0.0;
+        double reading = 2048.0 + 1200.0 * std::sin(i * 0.001) + noise + spike;
+        values[i] = reading < 0 ? 0 : (reading > 4095 ? 4095 : (int)reading);
+    }
+    return values;
+}
+
+// Repeats a whole-buffer operation until min_ns has passed.
+template <typename Operation>
+static Result timeRepeated(const Options& options, Operation operation) {
+    Result result;
+    unsigned long long batch = 1;
+    while (result.ns < options.min_ns) {
+        unsigned long long start_allocations = allocations, start_bytes = allocated_bytes;
+        Clock::time_point start = Clock::now();
+        for (unsigned long long i = 0; i < batch; ++i) operation();
+        result.ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        result.allocations += allocations - start_allocations;
+        result.bytes += allocated_bytes - start_bytes;
+        result.ops += batch;
+        batch *= 2;
+    }
+    return result;
+}
+
+// Times one call at a time and reloads the buffer between calls without timing the reload.
+template <typename Reload, typename Operation>
+static Result timeEach(const Options& options, Reload reload, Operation operation) {
+    Result result;
+    while (result.ns < options.min_ns) {
+        reload();
+        unsigned long long start_allocations = allocations, start_bytes = allocated_bytes;
+        Clock::time_point start = Clock::now();
+        operation();
+        result.ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        result.allocations += allocations - start_allocations;
+        result.bytes += allocated_bytes - start_bytes;
+        result.ops++;
+    }
+    return result;
+}
+
+static void report(const Options& options, const char* op, const char* type, int size, double items_per_op, const Result& result) {
+    double ns_per_op = result.ns / result.ops;
+    double items_per_s = items_per_op * 1e9 / ns_per_op;
+    double allocations_per_op = (double)result.allocations / result.ops;
+    double bytes_per_op = (double)result.bytes / result.ops;
+    if (options.csv) {
+        std::printf("%s,%s,%d,%s,%.3f,%.6g,%.3f,%.1f,%llu\n", op, type, size, options.data.c_str(),
+                    ns_per_op, items_per_s, allocations_per_op, bytes_per_op, result.ops);
+    } else {
+        std::printf("{\"op\":\"%s\",\"type\":\"%s\",\"size\":%d,\"data\":\"%s\",\"ns_per_op\":%.3f,"
+                    "\"items_per_s\":%.6g,\"allocs_per_op\":%.3f,\"bytes_per_op\":%.1f,\"ops\":%llu}\n",
+                    op, type, size, options.data.c_str(), ns_per_op, items_per_s, allocations_per_op,
+                    bytes_per_op, result.ops);
+    }
+    std::fflush(stdout);
+}
+
+template <typename T>
+static void runSize(const Options& options, const char* type, int size) {
+    std::vector<double> source = makeData(options.data, size);
+    std::vector<T> values(source.begin(), source.end());
+    VectorStats<T> buffer(size);
+    buffer.addBatch(values.data(), values.size());
+
+    // add() runs over the whole buffer per op so small and large sizes compare per element.
+    Result result = timeRepeated(options, [&] {
+        for (T value : values) buffer.add(value);
+    });
+    report(options, "add", type, size, size, result);
+
+    auto reload = [&] { buffer.zeroBuffer(); buffer.addBatch(values.data(), values.size()); };
+    reload();
+    result = timeRepeated(options, [&] { keep(buffer.getAverage()); });
+    report(options, "getAverage", type, size, size, result);
+    result = timeRepeated(options, [&] { keep(buffer.getStdDev()); });
+    report(options, "getStdDev", type, size, size, result);
+    result = timeRepeated(options, [&] { keep(buffer.getOutliers()); });
+    report(options, "getOutliers", type, size, size, result);
+    result = timeRepeated(options, [&] { keep(buffer.getSlope()); });
+    report(options, "getSlope", type, size, size, result);
+
+    result = timeEach(options, reload, [&] { keep(buffer.getMedian()); });
+    report(options, size % 2 ? "getMedian_odd" : "getMedian_even", type, size, size, result);
+    result = timeEach(options, reload, [&] { keep(buffer.getSortedElement(size / 2)); });
+    report(options, "getSortedElement", type, size, size, result);
+}
+
+template <typename T>
+static void runType(const Options& options, const char* type) {
+    const int sizes[] = {15, 255, 4095, 65535, 1048575};
+    for (int size : sizes) {
+        if (options.quick && size > 65535) break;
+        runSize<T>(options, type, size);
+        // The even neighbour exercises the center-two median path.
+        runSize<T>(options, type, size + 1);
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--csv")) {
+            options.csv = true;
+        } else if (!std::strcmp(argv[i], "--quick")) {
+            options.quick = true;
+        } else if (!std::strcmp(argv[i], "--min-ms") && i + 1 < argc) {
+            options.min_ns = std::atof(argv[++i]) * 1e6;
+        } else if (!std::strcmp(argv[i], "--data") && i + 1 < argc) {
+            options.data = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--csv] [--quick] [--min-ms N] [--data adc|ramp]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.csv) {
+        std::printf("op,type,size,data,ns_per_op,items_per_s,allocs_per_op,bytes_per_op,ops\n");
+    }
+    runType<int16_t>(options, "int16_t");
+    runType<int32_t>(options, "int32_t");
+    runType<int64_t>(options, "int64_t");
+    runType<float>(options, "float");
+    runType<double>(options, "double");
+    return 0;
+}
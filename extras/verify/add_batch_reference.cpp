@@ -0,0 +1,92 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for addBatch(). Two buffers with the same engines enabled take the same values, one through
+// addBatch() and the other through one add() per value, and must agree on the ring and on every statistic.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/add_batch_reference.cpp -o add_batch_reference
+//   ./add_batch_reference
+//
+// Batches range from empty to more than twice the buffer, so the wrapping copy and the skipped prefix of long
+// batches are both covered. Each seed enables a different set of engines. Both buffers are also sorted in place
+// now and then, so batches that wrap a reordered buffer back into order are covered too.
+// Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+// The histogram only takes integer types.
+static void enableHistogram(VectorStats<int16_t>& buffer) {
+    buffer.setHistogram(true, 10, 40);
+}
+static void enableHistogram(VectorStats<float>&) {}
+
+template <typename T>
+static void enable(VectorStats<T>& buffer, int engines) {
+    if (engines == 1) {
+        buffer.setRollingMedian(true);
+        buffer.setRollingExtrema(true);
+        buffer.setIncrementalMoments(true);
+    } else if (engines == 2) {
+        enableHistogram(buffer);
+        buffer.setQuantileSketch(true, 16, 7);
+    } else if (engines == 3) {
+        buffer.setSortedShadow(true);
+        buffer.setIncrementalMoments(true);
+    }
+}
+
+template <typename T>
+static void checkCase(const char* type, int size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    int engines = seed % 4;
+    VectorStats<T> batched(size), single(size);
+    enable(batched, engines);
+    enable(single, engines);
+
+    for (int step = 0; step < 300; ++step) {
+        int operation = random.below(8);
+        if (operation < 6) {
+            std::vector<T> batch(random.below(operation == 0 ? 3 * size : size / 2 + 3));
+            for (T& value : batch) value = (T)random.below(50);
+            batched.addBatch(batch.data(), batch.size());
+            for (T value : batch) single.add(value);
+        } else if (operation == 6) {
+            batched.getSortedElement(0);
+            single.getSortedElement(0);
+        } else {
+            batched.setBufferFullFalse();
+            single.setBufferFullFalse();
+        }
+
+        bool ring_match = batched.bufferFull() == single.bufferFull();
+        for (int slot = 0; slot < size; ++slot) {
+            ring_match = ring_match && batched.getElement(slot) == single.getElement(slot);
+        }
+        expect(ring_match, "buffer %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(batched.getMin() == single.getMin() && batched.getMax() == single.getMax(),
+               "getMin getMax %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(near(single.getAverage(), batched.getAverage(), 1e-6) && near(single.getStdDev(), batched.getStdDev(), 1e-4),
+               "getAverage getStdDev %s size=%d seed=%u step=%d", type, size, seed, step);
+        // A single element has no slope, so both are NaN.
+        float slope = single.getSlope(), batched_slope = batched.getSlope();
+        expect(std::isnan(slope) ? std::isnan(batched_slope) : near(slope, batched_slope, 1e-4),
+               "getSlope %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(batched.getStreamQuantile(0.5) == single.getStreamQuantile(0.5),
+               "getStreamQuantile %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(batched.getMedian() == single.getMedian(), "getMedian %s size=%d seed=%u step=%d", type, size, seed, step);
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 12; ++seed) {
+            checkCase<int16_t>("int16_t", size, seed);
+            checkCase<float>("float", size, seed);
+        }
+    }
+    return report();
+}
@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for setRollingExtrema(). Drives a buffer with random adds, batches, fills, reorders and restarts
+// while a plain copy of the ring is kept alongside, then compares getMin(), getMax() and getRange() with a scan
+// of the copy.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/extrema_reference.cpp -o extrema_reference
+//   ./extrema_reference
+//
+// getMedian() and getSortedElement() reorder the buffer in place. The copy is reordered with the same
+// std::nth_element and std::sort calls, so the deques must follow the new slots. setBufferFullFalse() restarts
+// the writes at element 0, which must become the next value to leave the deques. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+template <typename T>
+static void checkCase(const char* type, int size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    VectorStats<T> buffer(size);
+    buffer.setRollingExtrema(true);
+    std::vector<T> ring(size, 0);  // Slot order, as the buffer holds it.
+    int next = 0;
+    bool sorted = false;  // getMedian() leaves a sorted buffer as it is.
+
+    for (int step = 0; step < 400; ++step) {
+        int operation = random.below(12);
+        if (operation < 5) {
+            int count = random.below(operation == 0 ? 3 * size : 12);
+            for (int i = 0; i < count; ++i) {
+                T value = (T)((int)random.below(2000) - 1000);
+                buffer.add(value);
+                ring[next] = value;
+                next = (next + 1) % size;
+                sorted = false;
+            }
+        } else if (operation < 7) {
+            std::vector<T> batch(random.below(2 * size + 3));
+            for (T& value : batch) value = (T)((int)random.below(2000) - 1000);
+            buffer.addBatch(batch.data(), batch.size());
+            for (T value : batch) {
+                ring[next] = value;
+                next = (next + 1) % size;
+                sorted = false;
+            }
+        } else if (operation == 7) {
+            T value = (T)((int)random.below(2000) - 1000);
+            buffer.fillBuffer(value);
+            std::fill(ring.begin(), ring.end(), value);
+            sorted = false;
+        } else if (operation == 8) {
+            buffer.getMedian();
+            if (!sorted) {
+                std::nth_element(ring.begin(), ring.begin() + size / 2, ring.end());
+            }
+        } else if (operation == 9) {
+            buffer.getSortedElement(0);
+            std::sort(ring.begin(), ring.end());
+            sorted = true;
+        } else if (operation == 10) {
+            buffer.setBufferFullFalse();
+            next = 0;
+            sorted = false;
+        }
+
+        T low = *std::min_element(ring.begin(), ring.end());
+        T high = *std::max_element(ring.begin(), ring.end());
+        expect(buffer.getMin() == low, "getMin %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(buffer.getMax() == high, "getMax %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(buffer.getRange() == (T)(high - low), "getRange %s size=%d seed=%u step=%d", type, size, seed, step);
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<int16_t>("int16_t", size, seed);
+            checkCase<float>("float", size, seed);
+        }
+    }
+    return report();
+}
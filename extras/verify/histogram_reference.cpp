@@ -0,0 +1,94 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for setHistogram(). Drives a buffer with random adds, batches, fills and range changes
+// while a plain copy of the ring is kept alongside, then compares every rank answer with a full sort of the
+// copy after clamping it to the histogram range.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/histogram_reference.cpp -o histogram_reference
+//   ./histogram_reference
+//
+// The histogram range is narrower than the values, so both edge bins collect clamped values and the
+// lowest and highest ranks are read from them. Ranges are moved at random, which rebuilds the counts.
+// The ring order is also checked, since the histogram must never reorder the buffer. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+template <typename T>
+static void checkCase(const char* type, int size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    VectorStats<T> buffer(size);
+    T low = 20, high = 60;  // Values run from 0 to 79.
+    buffer.setHistogram(true, low, high);
+    std::vector<T> ring(size, 0);  // Slot order, as getElement() reports it.
+    int next = 0;
+
+    for (int step = 0; step < 400; ++step) {
+        int operation = random.below(10);
+        if (operation < 5) {
+            int count = random.below(operation == 0 ? 3 * size : 12);
+            for (int i = 0; i < count; ++i) {
+                T value = (T)random.below(80);
+                buffer.add(value);
+                ring[next] = value;
+                next = (next + 1) % size;
+            }
+        } else if (operation < 7) {
+            std::vector<T> batch(random.below(2 * size + 3));
+            for (T& value : batch) value = (T)random.below(80);
+            buffer.addBatch(batch.data(), batch.size());
+            for (T value : batch) {
+                ring[next] = value;
+                next = (next + 1) % size;
+            }
+        } else if (operation == 7) {
+            T value = (T)random.below(80);
+            buffer.fillBuffer(value);
+            std::fill(ring.begin(), ring.end(), value);
+        } else if (operation == 8) {
+            low = (T)random.below(40);
+            high = (T)(low + random.below(40));
+            buffer.setHistogram(true, low, high);
+        }
+
+        std::vector<T> sorted(ring);
+        for (T& value : sorted) value = value < low ? low : (value > high ? high : value);
+        std::sort(sorted.begin(), sorted.end());
+
+        T median = size % 2 ? sorted[size / 2] : (T)((sorted[size / 2 - 1] + sorted[size / 2]) / 2);
+        expect(buffer.getMedian() == median, "getMedian %s size=%d seed=%u step=%d", type, size, seed, step);
+
+        const double quantiles[3] = {0, 0.37, 1};
+        float results[3];
+        buffer.getQuantiles(quantiles, 3, results);
+        double position = 0.37 * (size - 1);
+        int lower = (int)position, upper = lower + 1 < size ? lower + 1 : lower;
+        double interpolated = sorted[lower] + (position - lower) * ((double)sorted[upper] - sorted[lower]);
+        expect(results[0] == sorted[0] && results[2] == sorted[size - 1] && results[1] == (float)interpolated,
+               "getQuantiles %s size=%d seed=%u step=%d", type, size, seed, step);
+
+        bool ranks_match = true, order_kept = true;
+        for (int rank = 0; rank < size; ++rank) {
+            ranks_match = ranks_match && buffer.getSortedElement(rank) == sorted[rank];
+        }
+        for (int slot = 0; slot < size; ++slot) {
+            order_kept = order_kept && buffer.getElement(slot) == ring[slot];
+        }
+        expect(ranks_match, "getSortedElement %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(order_kept, "buffer order %s size=%d seed=%u step=%d", type, size, seed, step);
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<uint8_t>("uint8_t", size, seed);
+            checkCase<int16_t>("int16_t", size, seed);
+        }
+    }
+    return report();
+}
@@ -0,0 +1,112 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for setIncrementalMoments(). Drives a buffer with random adds, batches, fills, sorts and
+// restarts while a plain copy of the ring is kept alongside, then compares the O(1) average, standard deviation
+// and slope with sums taken over the copy in insertion order.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/incremental_moments_reference.cpp -o incremental_moments_reference
+//   ./incremental_moments_reference
+//
+// getSortedElement() and setBufferFullFalse() leave the buffer out of insertion order. The slope must be -1
+// until adds wrap back past the end, and match the copy again from there. Batches longer than the buffer
+// and float values exercise the re-summing paths. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+// Integers keep a 16 bit friendly range, floats get quarter steps around an offset.
+template <typename T>
+static T randomValue(Random& random) {
+    return std::is_integral<T>::value ? (T)((int)random.below(1000) - 300) : (T)(random.below(4000) * 0.25 + 1000);
+}
+
+template <typename T>
+static void checkCase(const char* type, int max_size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    VectorStats<T> buffer(max_size);
+    buffer.setIncrementalMoments(true);
+    int size = max_size;
+    std::vector<T> ring(size, 0);  // Slot order, as the buffer holds it.
+    int next = 0;                  // Oldest slot and next write.
+    bool ordered = true;           // False from a sort or restart until the writes wrap.
+
+    for (int step = 0; step < 400; ++step) {
+        int operation = random.below(12);
+        if (operation < 5) {
+            int count = random.below(operation == 0 ? 3 * size : 12);
+            for (int i = 0; i < count; ++i) {
+                T value = randomValue<T>(random);
+                buffer.add(value);
+                ring[next] = value;
+                if (++next == size) {
+                    next = 0;
+                    ordered = true;
+                }
+            }
+        } else if (operation < 7) {
+            std::vector<T> batch(random.below(2 * size + 3));
+            for (T& value : batch) value = randomValue<T>(random);
+            buffer.addBatch(batch.data(), batch.size());
+            for (T value : batch) {
+                ring[next] = value;
+                if (++next == size) {
+                    next = 0;
+                    ordered = true;
+                }
+            }
+        } else if (operation == 7) {
+            T value = randomValue<T>(random);
+            buffer.fillBuffer(value);
+            std::fill(ring.begin(), ring.end(), value);
+            ordered = true;
+        } else if (operation == 8) {
+            buffer.getSortedElement(0);
+            std::sort(ring.begin(), ring.end());
+            ordered = false;
+        } else if (operation == 9) {
+            buffer.setBufferFullFalse();
+            next = 0;
+            ordered = false;
+        } else if (operation == 10) {
+            size = 1 + random.below(max_size);
+            buffer.resize(size);
+            ring.assign(size, 0);
+            next = 0;
+            ordered = true;
+        }
+
+        double sum = 0, weighted = 0, squares = 0;
+        for (int i = 0; i < size; ++i) {
+            double value = ring[(next + i) % size];
+            sum += value;
+            weighted += (i + 1) * value;
+        }
+        double mean = sum / size;
+        for (T value : ring) {
+            squares += (value - mean) * (value - mean);
+        }
+        double slope = (weighted - (1 + size) / 2.0 * sum) / ((double)size * ((double)size * size - 1) / 12.0);
+
+        expect(near(mean, buffer.getAverage(), 1e-6), "getAverage %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(near(std::sqrt(squares / size), buffer.getStdDev(), 1e-4),
+               "getStdDev %s size=%d seed=%u step=%d", type, size, seed, step);
+        if (size > 1) {
+            expect(ordered ? near(slope, buffer.getSlope(), 1e-4) : buffer.getSlope() == -1,
+                   "getSlope %s size=%d seed=%u step=%d", type, size, seed, step);
+        }
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<int16_t>("int16_t", size, seed);
+            checkCase<float>("float", size, seed);
+        }
+    }
+    return report();
+}
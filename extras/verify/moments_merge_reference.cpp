@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for VectorStatsMoments. Cuts a random stream into random blocks, sends every block's moments
+// through serialize() and deserialize(), merges them in a random order and compares the result with two plain
+// passes over the whole stream. Buffers exported with getMoments() across the wrap are checked the same way.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/moments_merge_reference.cpp -o moments_merge_reference
+//   ./moments_merge_reference
+//
+// Values sit on a large offset so a naive sum of squares would lose the variance. The round trip must be
+// bit exact and the serialized count must be little endian. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <cstring>
+#include <vector>
+#include "verify_common.h"
+
+// Count, mean, standard deviation, min, max and slope against x = 1..n of the whole stream.
+static void expectStream(const VectorStatsMoments& moments, const std::vector<float>& stream, const char* what,
+                         int length, unsigned int seed) {
+    double n = stream.size(), sum = 0, squares = 0, weighted = 0;
+    float low = stream[0], high = stream[0];
+    for (size_t i = 0; i < stream.size(); ++i) {
+        sum += stream[i];
+        weighted += (i + 1) * (double)stream[i];
+        low = stream[i] < low ? stream[i] : low;
+        high = stream[i] > high ? stream[i] : high;
+    }
+    double mean = sum / n;
+    for (float value : stream) {
+        squares += (value - mean) * (value - mean);
+    }
+    double slope = n > 1 ? (weighted - (n + 1) / 2 * sum) / (n * (n * n - 1) / 12) : 0;
+
+    expect(moments.count == stream.size() && moments.min == low && moments.max == high,
+           "%s count min max length=%d seed=%u", what, length, seed);
+    expect(near(mean, moments.mean, 1e-12), "%s mean length=%d seed=%u", what, length, seed);
+    expect(near(std::sqrt(squares / n), moments.getStdDev(), 1e-9), "%s getStdDev length=%d seed=%u", what, length, seed);
+    expect(std::fabs(slope - moments.getSlope()) <= 1e-9 * (high - low + 1), "%s getSlope length=%d seed=%u",
+           what, length, seed);
+}
+
+static VectorStatsMoments roundTrip(const VectorStatsMoments& moments, int length, unsigned int seed) {
+    uint8_t bytes[VectorStatsMoments::serialized_size];
+    moments.serialize(bytes);
+    VectorStatsMoments copy = VectorStatsMoments::deserialize(bytes);
+    bool count_little_endian = true;
+    for (int i = 0; i < 8; ++i) {
+        count_little_endian = count_little_endian && bytes[i] == (uint8_t)(moments.count >> (8 * i));
+    }
+    expect(count_little_endian && std::memcmp(&copy, &moments, sizeof(moments)) == 0,
+           "round trip length=%d seed=%u", length, seed);
+    return copy;
+}
+
+static void checkStream(int length, unsigned int seed) {
+    Random random = {seed + 1ull};
+    std::vector<float> stream(length);
+    for (float& value : stream) value = 10000 + random.below(1000) * 0.01f;
+
+    // Blocks keep their place in the stream through x_start, so they merge in any order.
+    std::vector<VectorStatsMoments> blocks;
+    for (int start = 0; start < length;) {
+        int count = 1 + random.below(length - start < 200 ? length - start : 200);
+        blocks.push_back(roundTrip(VectorStatsMoments::fromData(stream.data() + start, count, start + 1), length, seed));
+        start += count;
+    }
+    while (blocks.size() > 1) {
+        int a = random.below(blocks.size()), b = random.below(blocks.size() - 1);
+        b += b >= a;
+        blocks[a].merge(blocks[b]);
+        blocks.erase(blocks.begin() + b);
+    }
+    expectStream(blocks[0], stream, "merged", length, seed);
+
+    // Welford adds over the same stream.
+    VectorStatsMoments added;
+    for (float value : stream) added.add(value);
+    expectStream(roundTrip(added, length, seed), stream, "added", length, seed);
+
+    // Two buffers that split the stream, each wrapped part way, exported with getMoments().
+    int first = length / 2, second = length - first;
+    if (first > 0) {
+        VectorStats<float> older(first), newer(second);
+        std::vector<float> lead(random.below(3 * first));
+        for (float& value : lead) value = random.below(1000) * 0.5f;
+        older.addBatch(lead.data(), lead.size());
+        newer.addBatch(lead.data(), lead.size() < (size_t)second ? lead.size() : second);
+        for (int i = 0; i < first; ++i) older.add(stream[i]);
+        for (int i = first; i < length; ++i) newer.add(stream[i]);
+        VectorStatsMoments buffers = roundTrip(newer.getMoments(first + 1), length, seed);
+        buffers.merge(roundTrip(older.getMoments(), length, seed));
+        expectStream(buffers, stream, "getMoments", length, seed);
+    }
+}
+
+int main() {
+    const int lengths[] = {1, 2, 3, 10, 199, 200, 1001, 20000};
+    for (int length : lengths) {
+        for (unsigned int seed = 0; seed < 20; ++seed) {
+            checkStream(length, seed);
+        }
+    }
+    return report();
+}
@@ -0,0 +1,63 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for VectorStatsParallel. Runs every parallel statistic next to the serial path of an
+// identical buffer and reports any difference.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -pthread -Isrc extras/verify/parallel_reference.cpp -o parallel_reference
+//   ./parallel_reference
+//
+// The pool threshold is lowered so buffers from a few thousand elements up take the parallel path.
+// Medians must match exactly. Sums may differ by rounding, so averages, standard deviations and slopes
+// are compared with a relative tolerance. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define VECTORSTATS_PARALLEL
+#include <VectorStats.h>
+#include "verify_common.h"
+
+// random spans most of int16_t, ties repeats 7 values so the median lands inside long runs of equal values.
+template <typename T>
+static void fill(VectorStats<T>& buffer, const char* data, int size) {
+    Random random = {12345ull + size};
+    for (int i = 0; i < size; ++i) {
+        double value = data[0] == 't' ? i % 7 : (double)random.below(60001) - 30000;
+        buffer.add((T)value);
+    }
+}
+
+template <typename T>
+static void checkCase(VectorStatsParallel& pool, const char* type, int size, const char* data) {
+    VectorStats<T> serial(size), parallel(size);
+    fill(serial, data, size);
+    fill(parallel, data, size);
+    parallel.setParallel(&pool);
+
+    expect(near(serial.getAverage(), parallel.getAverage(), 1e-6), "getAverage %s size=%d data=%s", type, size, data);
+    expect(near(serial.getStdDev(), parallel.getStdDev(), 1e-5), "getStdDev %s size=%d data=%s", type, size, data);
+    expect(serial.getOutliers(1) == parallel.getOutliers(1), "getOutliers %s size=%d data=%s", type, size, data);
+    expect(near(serial.getSlope(), parallel.getSlope(), 1e-4), "getSlope %s size=%d data=%s", type, size, data);
+    expect(serial.getMedian() == parallel.getMedian(), "getMedian %s size=%d data=%s", type, size, data);
+}
+
+template <typename T>
+static void checkType(VectorStatsParallel& pool, const char* type) {
+    const int sizes[] = {4095, 4096, 65535, 65536, 1048575, 1048576};
+    const char* datas[] = {"random", "ties"};
+    for (int size : sizes) {
+        for (const char* data : datas) {
+            checkCase<T>(pool, type, size, data);
+        }
+    }
+}
+
+int main() {
+    VectorStatsParallel pool(4);
+    pool.setThreshold(1000);
+
+    checkType<int16_t>(pool, "int16_t");
+    checkType<int32_t>(pool, "int32_t");
+    checkType<float>(pool, "float");
+    checkType<double>(pool, "double");
+
+    return report();
+}
@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for VectorStatsQuantileSketch. Sorts every value of a stream and measures the rank error
+// of the sketch's quantiles against the exact ranks.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/quantile_sketch_reference.cpp -o quantile_sketch_reference
+//   ./quantile_sketch_reference
+//
+// Each stream is checked through one sketch and through 8 sketches fed round robin, then merged, as per-channel
+// sketches would be. Quantiles 0.01 to 0.99 are estimated. A value shared by many samples is credited with its
+// whole run of ranks. With k = 200 the worst rank error must stay below 1.5%. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "verify_common.h"
+
+static const int k = 200;
+static const double max_error = 0.015;
+
+// adc is noisy 12 bit readings with drift, ties repeats 10 values, ramp and reversed arrive sorted.
+static std::vector<int32_t> makeStream(const char* kind, int size) {
+    std::vector<int32_t> values(size);
+    Random random = {12345};
+    for (int i = 0; i < size; ++i) {
+        unsigned int noise = random.below(201);
+        if (!std::strcmp(kind, "ties")) {
+            values[i] = noise % 10;
+        } else if (!std::strcmp(kind, "ramp")) {
+            values[i] = i;
+        } else if (!std::strcmp(kind, "reversed")) {
+            values[i] = size - i;
+        } else {
+            values[i] = (int32_t)(2048 + 1200 * std::sin(i * 0.0001)) + (int32_t)noise - 100;
+        }
+    }
+    return values;
+}
+
+// Distance from quantile to the range of ranks held by estimate.
+static double worstRankError(const VectorStatsQuantileSketch<int32_t>& sketch, const std::vector<int32_t>& sorted) {
+    double worst = 0;
+    double size = sorted.size();
+    for (int percent = 1; percent < 100; ++percent) {
+        double quantile = percent / 100.0;
+        int32_t estimate = sketch.getQuantile(quantile);
+        double low = (std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / size;
+        double high = (std::upper_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / size;
+        double error = quantile < low ? low - quantile : (quantile > high ? quantile - high : 0);
+        worst = std::max(worst, error);
+    }
+    return worst;
+}
+
+static void checkStream(const char* kind, int size) {
+    std::vector<int32_t> values = makeStream(kind, size);
+    std::vector<int32_t> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    VectorStatsQuantileSketch<int32_t> single(k);
+    VectorStatsQuantileSketch<int32_t> channels[8];
+    for (int i = 0; i < size; ++i) {
+        single.add(values[i]);
+        channels[i % 8].add(values[i]);
+    }
+    VectorStatsQuantileSketch<int32_t> merged(k);
+    for (const VectorStatsQuantileSketch<int32_t>& channel : channels) {
+        merged.merge(channel);
+    }
+
+    const VectorStatsQuantileSketch<int32_t>* sketches[2] = {&single, &merged};
+    const char* names[2] = {"single", "merged"};
+    for (int i = 0; i < 2; ++i) {
+        double error = worstRankError(*sketches[i], sorted);
+        bool passed = error < max_error && sketches[i]->count() == (uint64_t)size;
+        expect(passed, "%s %s size=%d worst_rank_error=%.4f", names[i], kind, size, error);
+        std::printf("%s %s size=%d worst_rank_error=%.4f retained=%d\n", names[i], kind, size, error,
+                    sketches[i]->retained());
+    }
+}
+
+int main() {
+    const char* kinds[] = {"adc", "ties", "ramp", "reversed"};
+    const int sizes[] = {10000, 1000000};
+    for (const char* kind : kinds) {
+        for (int size : sizes) {
+            checkStream(kind, size);
+        }
+    }
+    return report();
+}
@@ -0,0 +1,104 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for the robust statistics. Fills buffers with noise and spikes through random adds and batches,
+// then compares getMAD(), getHampelOutliers(), getTrimmedMean() and getWinsorizedMean() with the same
+// definitions taken from a full sort of a plain copy of the ring.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/robust_reference.cpp -o robust_reference
+//   ./robust_reference
+//
+// Proportions run from 0 to past 0.5, where the cut is clamped to keep at least one value. Every answer works
+// on a scratch copy, so the ring order is checked after each round too. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+// Mostly small noise with the odd spike far away on either side.
+template <typename T>
+static T randomValue(Random& random) {
+    int value = (int)random.below(100);
+    if (random.below(20) == 0) {
+        value += random.below(2) ? 5000 : -5000;
+    }
+    return (T)value;
+}
+
+template <typename T>
+static void checkCase(const char* type, int size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    VectorStats<T> buffer(size);
+    std::vector<T> ring(size, 0);  // Slot order, as getElement() reports it.
+    int next = 0;
+
+    for (int step = 0; step < 100; ++step) {
+        std::vector<T> values(random.below(2 * size + 3));
+        for (T& value : values) value = randomValue<T>(random);
+        if (random.below(2)) {
+            buffer.addBatch(values.data(), values.size());
+        } else {
+            for (T value : values) buffer.add(value);
+        }
+        for (T value : values) {
+            ring[next] = value;
+            next = (next + 1) % size;
+        }
+
+        std::vector<T> sorted(ring);
+        std::sort(sorted.begin(), sorted.end());
+        double median = size % 2 ? sorted[size / 2] : ((double)sorted[size / 2 - 1] + sorted[size / 2]) / 2;
+        std::vector<float> deviations(size);
+        for (int i = 0; i < size; ++i) {
+            deviations[i] = std::fabs((double)ring[i] - median);
+        }
+        std::sort(deviations.begin(), deviations.end());
+        double mad = size % 2 ? deviations[size / 2] : ((double)deviations[size / 2 - 1] + deviations[size / 2]) / 2;
+        expect(near(mad, buffer.getMAD(), 1e-6), "getMAD %s size=%d seed=%u step=%d", type, size, seed, step);
+
+        const float thresholds[3] = {1, 2, 3};
+        for (float threshold : thresholds) {
+            double limit = threshold * 1.4826 * mad;
+            int outliers = 0;
+            for (T value : ring) {
+                outliers += value < median - limit || value > median + limit;
+            }
+            expect(buffer.getHampelOutliers(threshold) == outliers,
+                   "getHampelOutliers %g %s size=%d seed=%u step=%d", threshold, type, size, seed, step);
+        }
+
+        const float proportions[6] = {0, 0.05f, 0.1f, 0.25f, 0.49f, 0.6f};
+        for (float proportion : proportions) {
+            int cut = (int)(proportion * size);
+            cut = 2 * cut >= size ? (size - 1) / 2 : cut;
+            double trimmed = 0, winsorized = 0;
+            for (int i = 0; i < size; ++i) {
+                T clamped = sorted[i < cut ? cut : (i >= size - cut ? size - cut - 1 : i)];
+                trimmed += i < cut || i >= size - cut ? 0 : (double)sorted[i];
+                winsorized += clamped;
+            }
+            expect(near(trimmed / (size - 2 * cut), buffer.getTrimmedMean(proportion), 1e-6),
+                   "getTrimmedMean %g %s size=%d seed=%u step=%d", proportion, type, size, seed, step);
+            expect(near(winsorized / size, buffer.getWinsorizedMean(proportion), 1e-6),
+                   "getWinsorizedMean %g %s size=%d seed=%u step=%d", proportion, type, size, seed, step);
+        }
+
+        bool order_kept = true;
+        for (int slot = 0; slot < size; ++slot) {
+            order_kept = order_kept && buffer.getElement(slot) == ring[slot];
+        }
+        expect(order_kept, "buffer order %s size=%d seed=%u step=%d", type, size, seed, step);
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000, 4095};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<int16_t>("int16_t", size, seed);
+            checkCase<float>("float", size, seed);
+        }
+    }
+    return report();
+}
@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for setRollingMedian(). Drives a buffer with random adds, batches, fills, sorts and resizes
+// while a plain copy of the ring is kept alongside, then compares every median with a full sort of the copy.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/rolling_median_reference.cpp -o rolling_median_reference
+//   ./rolling_median_reference
+//
+// getSortedElement() sorts the buffer in place, so the copy is sorted too and both carry on from there.
+// The median is also switched off and on again, which rebuilds the two heaps from the buffer.
+// Values come from a small range so ties between the heaps are common. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+template <typename T>
+static void checkCase(const char* type, int max_size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    VectorStats<T> buffer(max_size);
+    buffer.setRollingMedian(true);
+    int size = max_size;
+    std::vector<T> ring(size, 0);  // Slot order, as the buffer holds it.
+    int next = 0;
+
+    for (int step = 0; step < 400; ++step) {
+        int operation = random.below(12);
+        if (operation < 5) {
+            int count = random.below(operation == 0 ? 3 * size : 12);
+            for (int i = 0; i < count; ++i) {
+                T value = (T)random.below(50);
+                buffer.add(value);
+                ring[next] = value;
+                next = (next + 1) % size;
+            }
+        } else if (operation < 7) {
+            std::vector<T> batch(random.below(2 * size + 3));
+            for (T& value : batch) value = (T)random.below(50);
+            buffer.addBatch(batch.data(), batch.size());
+            for (T value : batch) {
+                ring[next] = value;
+                next = (next + 1) % size;
+            }
+        } else if (operation == 7) {
+            T value = (T)random.below(50);
+            buffer.fillBuffer(value);
+            std::fill(ring.begin(), ring.end(), value);
+        } else if (operation == 8) {
+            buffer.getSortedElement(0);
+            std::sort(ring.begin(), ring.end());
+        } else if (operation == 9) {
+            size = 1 + random.below(max_size);
+            buffer.resize(size);
+            ring.assign(size, 0);
+            next = 0;
+        } else if (operation == 10) {
+            buffer.setRollingMedian(false);
+            buffer.setRollingMedian(true);
+        }
+
+        std::vector<T> sorted(ring);
+        std::sort(sorted.begin(), sorted.end());
+        T median = size % 2 ? sorted[size / 2] : (T)((sorted[size / 2 - 1] + sorted[size / 2]) / 2);
+        expect(buffer.getMedian() == median, "getMedian %s size=%d seed=%u step=%d", type, size, seed, step);
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<int16_t>("int16_t", size, seed);
+            checkCase<float>("float", size, seed);
+        }
+    }
+    return report();
+}
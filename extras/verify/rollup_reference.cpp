@@ -0,0 +1,126 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for VectorStatsRollup. Keeps every sample of a random stream next to rollups of several shapes,
+// then compares every kept bucket, every open bucket and merged windows with two plain passes over the samples
+// each of them covers.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/rollup_reference.cpp -o rollup_reference
+//   ./rollup_reference
+//
+// A level i bucket covers the product of fanouts 0 to i samples, so the covered samples follow from count().
+// Windows ask for more buckets than are kept as well. With sketches on, window quantiles must land within the
+// sketch's rank error of the covered samples. clear() is called part way through some streams.
+// Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStatsRollup.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+struct Shape {
+    int fanouts[4];
+    int levels;
+    int history;
+};
+
+// Compares moments with samples [first, last) of the stream at x = first + 1 onwards.
+template <typename T>
+static void expectSpan(const VectorStatsMoments& moments, const std::vector<T>& stream, uint64_t first, uint64_t last,
+                       const char* what, int shape, unsigned int seed, int level) {
+    double n = (double)(last - first), sum = 0, squares = 0, weighted = 0;
+    T low = n > 0 ? stream[first] : 0, high = low;
+    for (uint64_t i = first; i < last; ++i) {
+        sum += stream[i];
+        weighted += (i - first) * (double)stream[i];
+        low = std::min(low, stream[i]);
+        high = std::max(high, stream[i]);
+    }
+    double mean = n > 0 ? sum / n : 0;
+    for (uint64_t i = first; i < last; ++i) {
+        squares += (stream[i] - mean) * (stream[i] - mean);
+    }
+    double slope = n > 1 ? (weighted - (n - 1) / 2 * sum) / (n * (n * n - 1) / 12) : 0;
+    double mean_x = n > 0 ? first + 1 + (n - 1) / 2 : 0;
+
+    bool matches = moments.count == last - first;
+    if (n > 0) {
+        matches = matches && moments.min == low && moments.max == high && near(mean, moments.mean, 1e-12) &&
+                  near(mean_x, moments.mean_x, 1e-12) && near(std::sqrt(squares / n), moments.getStdDev(), 1e-9) &&
+                  std::fabs(slope - moments.getSlope()) <= 1e-9 * (high - low + 1);
+    }
+    expect(matches, "%s shape=%d seed=%u level=%d count=%d", what, shape, seed, level, (int)stream.size());
+}
+
+template <typename T>
+static void checkCase(const Shape& shape, int index, unsigned int seed, bool sketches) {
+    Random random = {seed + 1ull};
+    VectorStatsRollup<T> rollup(shape.fanouts, shape.levels, shape.history);
+    rollup.setQuantileSketch(sketches, 200);
+    std::vector<T> stream;
+
+    for (int step = 0; step < 60; ++step) {
+        if (random.below(30) == 0) {
+            rollup.clear();
+            stream.clear();
+        }
+        int count = random.below(400);
+        for (int i = 0; i < count; ++i) {
+            T value = (T)(1000 + random.below(2000) * (std::is_integral<T>::value ? 1 : 0.25));
+            rollup.add(value);
+            stream.push_back(value);
+        }
+        expect(rollup.count() == stream.size(), "count shape=%d seed=%u step=%d", index, seed, step);
+
+        // An open bucket holds the completed children of the level below, up to where that level's open bucket starts.
+        uint64_t span = 1, child_end = stream.size();
+        for (int level = 0; level < shape.levels; ++level) {
+            span *= shape.fanouts[level] > 1 ? shape.fanouts[level] : 1;
+            uint64_t completed = stream.size() / span;
+            int kept = (int)std::min<uint64_t>(completed, shape.history);
+            expect(rollup.buckets(level) == kept, "buckets shape=%d seed=%u level=%d", index, seed, level);
+
+            for (int age = 0; age < kept; ++age) {
+                uint64_t last = (completed - age) * span;
+                expectSpan(rollup.getBucket(level, age), stream, last - span, last, "getBucket", index, seed, level);
+            }
+            expectSpan(rollup.getOpen(level), stream, completed * span, child_end, "getOpen", index, seed, level);
+            child_end = completed * span;
+
+            int asked = random.below(shape.history + 2);
+            int merged = std::min(asked, kept);
+            uint64_t first = (completed - merged) * span, last = completed * span;
+            expectSpan(rollup.getWindow(level, asked), stream, first, last, "getWindow", index, seed, level);
+
+            if (sketches && merged > 0) {
+                // The estimate must rank within 2% of the window of the asked rank, twice the error of k = 200.
+                std::vector<T> window(stream.begin() + first, stream.begin() + last);
+                std::sort(window.begin(), window.end());
+                double quantile = random.below(101) / 100.0, size = (double)window.size();
+                T estimate = rollup.getWindowQuantile(level, asked, quantile);
+                double below = std::lower_bound(window.begin(), window.end(), estimate) - window.begin();
+                double through = std::upper_bound(window.begin(), window.end(), estimate) - window.begin();
+                double rank = quantile * (size - 1), slack = 0.02 * size + 1;
+                expect(below - slack <= rank && rank <= through + slack,
+                       "getWindowQuantile shape=%d seed=%u level=%d", index, seed, level);
+            }
+        }
+    }
+}
+
+int main() {
+    const Shape shapes[] = {
+        {{4, 0, 0, 0}, 1, 5},
+        {{3, 5, 2, 0}, 3, 3},
+        {{1, 7, 1, 3}, 4, 8},
+        {{10, 6, 0, 0}, 2, 1},
+        {{25, 4, 4, 0}, 3, 12},
+    };
+    for (int index = 0; index < 5; ++index) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<int16_t>(shapes[index], index, seed, seed % 2 == 1);
+            checkCase<float>(shapes[index], index, seed, seed % 2 == 0);
+        }
+    }
+    return report();
+}
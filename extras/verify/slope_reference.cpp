@@ -0,0 +1,107 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for getSlope(). Drives a plain buffer and one with incremental moments through random adds,
+// batches, fills, sorts and restarts while a plain copy of the ring is kept alongside, then compares every
+// slope with a regression over the copy in insertion order, from the oldest element across the wrap.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/slope_reference.cpp -o slope_reference
+//   ./slope_reference
+//
+// getSummary().slope, getMoments().getSlope() and a two part VectorStatsView over the copy are compared too.
+// Sorted and restarted buffers must report -1 until the writes wrap back. Values follow a ramp with noise so
+// the slope is far from zero and a wrong x order shows. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStatsView.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+template <typename T>
+static void checkCase(const char* type, int size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    VectorStats<T> plain(size), incremental(size);
+    incremental.setIncrementalMoments(true);
+    std::vector<T> ring(size, 0);  // Slot order, as the buffers hold it.
+    int next = 0;                  // Oldest slot and next write.
+    bool ordered = true;           // False from a sort or restart until the writes wrap.
+    int ramp = 0;
+
+    for (int step = 0; step < 300; ++step) {
+        int operation = random.below(10);
+        if (operation < 7) {
+            std::vector<T> values(random.below(operation == 0 ? 3 * size : size / 3 + 3));
+            for (T& value : values) value = (T)(ramp++ % 2000 / 4 + random.below(40));
+            if (operation < 4) {
+                for (T value : values) {
+                    plain.add(value);
+                    incremental.add(value);
+                }
+            } else {
+                plain.addBatch(values.data(), values.size());
+                incremental.addBatch(values.data(), values.size());
+            }
+            for (T value : values) {
+                ring[next] = value;
+                if (++next == size) {
+                    next = 0;
+                    ordered = true;
+                }
+            }
+        } else if (operation == 7) {
+            T value = (T)random.below(500);
+            plain.fillBuffer(value);
+            incremental.fillBuffer(value);
+            std::fill(ring.begin(), ring.end(), value);
+            ordered = true;
+        } else if (operation == 8) {
+            plain.getSortedElement(0);
+            incremental.getSortedElement(0);
+            std::sort(ring.begin(), ring.end());
+            ordered = false;
+        } else {
+            plain.setBufferFullFalse();
+            incremental.setBufferFullFalse();
+            next = 0;
+            ordered = false;
+        }
+
+        if (size == 1) {
+            expect(!ordered || (std::isnan(plain.getSlope()) && std::isnan(incremental.getSlope())),
+                   "getSlope NaN %s size=%d seed=%u step=%d", type, size, seed, step);
+            continue;
+        }
+        if (!ordered) {
+            expect(plain.getSlope() == -1 && incremental.getSlope() == -1 && plain.getSummary().slope == -1,
+                   "getSlope reordered %s size=%d seed=%u step=%d", type, size, seed, step);
+            continue;
+        }
+        double sum = 0, weighted = 0;
+        for (int i = 0; i < size; ++i) {
+            sum += ring[(next + i) % size];
+            weighted += (i + 1) * (double)ring[(next + i) % size];
+        }
+        double slope = (weighted - (1 + size) / 2.0 * sum) / ((double)size * ((double)size * size - 1) / 12.0);
+        VectorStatsView<T> view(ring.data() + next, size - next, ring.data(), next);
+
+        expect(near(slope, plain.getSlope(), 1e-5), "getSlope %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(near(slope, incremental.getSlope(), 1e-5),
+               "incremental getSlope %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(near(slope, plain.getSummary().slope, 1e-5),
+               "getSummary slope %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(near(slope, plain.getMoments().getSlope(), 1e-9),
+               "getMoments slope %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(near(slope, view.getSlope(), 1e-5), "view getSlope %s size=%d seed=%u step=%d", type, size, seed, step);
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<int16_t>("int16_t", size, seed);
+            checkCase<float>("float", size, seed);
+        }
+    }
+    return report();
+}
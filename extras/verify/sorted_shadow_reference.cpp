@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for setSortedShadow(). Drives a buffer with random adds, batches, fills and rank queries
+// while a plain copy of the ring is kept alongside, then compares every rank answer with a full sort of the copy.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/sorted_shadow_reference.cpp -o sorted_shadow_reference
+//   ./sorted_shadow_reference
+//
+// Bursts range from single adds, which take the binary search and shift path, to more than a whole buffer,
+// which makes the shadow sort itself again. Values come from a small range so ties are common.
+// The ring order is also checked, since the shadow must never reorder the buffer. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+template <typename T>
+static void checkCase(const char* type, int size, unsigned int seed) {
+    Random random = {seed + 1ull};
+    VectorStats<T> buffer(size);
+    buffer.setSortedShadow(true);
+    std::vector<T> ring(size, 0);  // Slot order, as getElement() reports it.
+    int next = 0;
+
+    for (int step = 0; step < 400; ++step) {
+        int operation = random.below(10);
+        if (operation < 5) {
+            int count = random.below(operation == 0 ? 3 * size : 12);
+            for (int i = 0; i < count; ++i) {
+                T value = (T)random.below(50);
+                buffer.add(value);
+                ring[next] = value;
+                next = (next + 1) % size;
+            }
+        } else if (operation < 7) {
+            std::vector<T> batch(random.below(2 * size + 3));
+            for (T& value : batch) value = (T)random.below(50);
+            buffer.addBatch(batch.data(), batch.size());
+            for (T value : batch) {
+                ring[next] = value;
+                next = (next + 1) % size;
+            }
+        } else if (operation == 7) {
+            T value = (T)random.below(50);
+            buffer.fillBuffer(value);
+            std::fill(ring.begin(), ring.end(), value);
+        } else if (operation == 8) {
+            buffer.zeroBuffer();
+            std::fill(ring.begin(), ring.end(), 0);
+            next = 0;
+        }
+
+        std::vector<T> sorted(ring);
+        std::sort(sorted.begin(), sorted.end());
+
+        T median = size % 2 ? sorted[size / 2] : (T)((sorted[size / 2 - 1] + sorted[size / 2]) / 2);
+        expect(buffer.getMedian() == median, "getMedian %s size=%d seed=%u step=%d", type, size, seed, step);
+
+        const double quantiles[3] = {0, 0.5, 1};
+        float results[3];
+        buffer.getQuantiles(quantiles, 3, results);
+        double middle = 0.5 * (size - 1);
+        int low = (int)middle, high = low + 1 < size ? low + 1 : low;
+        double interpolated = sorted[low] + (middle - low) * ((double)sorted[high] - sorted[low]);
+        expect(results[0] == sorted[0] && results[2] == sorted[size - 1] && results[1] == (float)interpolated,
+               "getQuantiles %s size=%d seed=%u step=%d", type, size, seed, step);
+
+        bool ranks_match = true, order_kept = true;
+        for (int rank = 0; rank < size; ++rank) {
+            ranks_match = ranks_match && buffer.getSortedElement(rank) == sorted[rank];
+        }
+        for (int slot = 0; slot < size; ++slot) {
+            order_kept = order_kept && buffer.getElement(slot) == ring[slot];
+        }
+        expect(ranks_match, "getSortedElement %s size=%d seed=%u step=%d", type, size, seed, step);
+        expect(order_kept, "buffer order %s size=%d seed=%u step=%d", type, size, seed, step);
+    }
+}
+
+int main() {
+    const int sizes[] = {1, 2, 3, 7, 64, 101, 1000};
+    for (int size : sizes) {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            checkCase<int16_t>("int16_t", size, seed);
+            checkCase<float>("float", size, seed);
+        }
+    }
+    return report();
+}
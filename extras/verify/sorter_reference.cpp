@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reference check for VectorStatsSorter. Sorts the same data with the counting and radix sort engine and with
+// std::sort and reports any difference.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Isrc extras/verify/sorter_reference.cpp -o sorter_reference
+//   ./sorter_reference
+//
+// Sizes sit on both sides of the engine's std::sort cutoffs. Value ranges cover narrow ranges that take the
+// counting sort, full type ranges that take the radix sort, and a single outlier that widens a narrow range.
+// One sorter is reused for every case of a type so its kept scratch memory is exercised at shrinking sizes.
+// getSortedElement() is checked on a VectorStats buffer as well, up to 65536 elements. Exits with 1 if any case fails.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <VectorStats.h>
+#include <algorithm>
+#include <vector>
+#include "verify_common.h"
+
+// Values from low to high inclusive, with a shape applied afterwards.
+template <typename T>
+static std::vector<T> makeData(int size, long long low, long long high, const char* shape, unsigned int seed) {
+    Random random = {seed + 1ull};
+    std::vector<T> values(size);
+    unsigned long long span = (unsigned long long)(high - low) + 1;
+    for (T& value : values) {
+        value = (T)(low + (long long)(span ? random.next() % span : random.next()));
+    }
+    if (shape[0] == 's') {
+        std::sort(values.begin(), values.end());
+    } else if (shape[0] == 'r') {
+        std::sort(values.begin(), values.end());
+        std::reverse(values.begin(), values.end());
+    } else if (shape[0] == 'o' && size > 0) {
+        values[size / 2] = (T)high;
+        values[0] = (T)low;
+    }
+    return values;
+}
+
+template <typename T>
+static void checkCase(VectorStatsSorter<T>& sorter, const char* type, int size, long long low, long long high,
+                      const char* shape, unsigned int seed) {
+    std::vector<T> values = makeData<T>(size, low, high, shape, seed);
+    std::vector<T> expected(values), sorted(values);
+    std::sort(expected.begin(), expected.end());
+    sorter.sort(sorted.data(), size);
+
+    bool buffer_matches = true;
+    if (size > 0 && size <= 65536) {
+        VectorStats<T> buffer(size);
+        buffer.addBatch(values.data(), size);
+        for (int i = 0; i < size; i += 1 + size / 64) {
+            buffer_matches = buffer_matches && buffer.getSortedElement(i) == expected[i];
+        }
+    }
+
+    expect(sorted == expected && buffer_matches, "%s size=%d range=[%lld, %lld] shape=%s seed=%u", type, size, low,
+           high, shape, seed);
+}
+
+template <typename T>
+static void checkType(const char* type, long long lowest, long long highest) {
+    const int sizes[] = {1048576, 65536, 4097, 2049, 2048, 2047, 1000, 257, 256, 255, 2, 1};
+    const char* shapes[] = {"random", "sorted", "reversed", "outlier"};
+    // Narrow ranges take the counting sort until the outlier shape widens them.
+    const long long ranges[][2] = {{0, 4095}, {-5, 5}, {7, 7}, {lowest, highest}, {lowest, lowest + 300}, {highest - 300, highest}};
+    VectorStatsSorter<T> sorter;
+    for (int size : sizes) {
+        for (const long long* range : ranges) {
+            long long low = std::max(range[0], lowest), high = std::min(range[1], highest);
+            for (const char* shape : shapes) {
+                for (unsigned int seed = 0; seed < (size > 65536 ? 1u : 3u); ++seed) {
+                    checkCase<T>(sorter, type, size, low, high, shape, seed);
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    checkType<int8_t>("int8_t", -128, 127);
+    checkType<uint8_t>("uint8_t", 0, 255);
+    checkType<int16_t>("int16_t", -32768, 32767);
+    checkType<uint16_t>("uint16_t", 0, 65535);
+    checkType<int32_t>("int32_t", -2147483648LL, 2147483647LL);
+    checkType<uint32_t>("uint32_t", 0, 4294967295LL);
+    checkType<int64_t>("int64_t", -1000000, 1000000);
+    checkType<float>("float", -1000, 1000);
+    return report();
+}
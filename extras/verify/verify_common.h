@@ -0,0 +1,54 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Shared harness for the reference checks in extras/verify. Each program includes this after VectorStats.h,
+// calls expect() once per compared result and returns report() from main().
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef VECTORSTATS_VERIFY_COMMON_H
+#define VECTORSTATS_VERIFY_COMMON_H
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+
+static int failures = 0;
+static int checks = 0;
+
+// Counts one check. A failed check prints FAIL and the printf style description of the case.
+inline void expect(bool passed, const char* format, ...) {
+    checks++;
+    if (!passed) {
+        failures++;
+        va_list arguments;
+        va_start(arguments, format);
+        std::printf("FAIL ");
+        std::vprintf(format, arguments);
+        std::printf("\n");
+        va_end(arguments);
+    }
+}
+
+// True if a and b agree to a tolerance relative to a.
+inline bool near(double a, double b, double tolerance) {
+    return std::fabs(a - b) <= tolerance * (1.0 + std::fabs(a));
+}
+
+// 64 bit linear congruential generator. Seeded by aggregate initialization, e.g. Random random = {seed + 1}.
+struct Random {
+    unsigned long long state;
+    unsigned long long next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 11;
+    }
+    // Uniform value from 0 to range - 1.
+    unsigned int below(unsigned int range) {
+        return (unsigned int)(next() % range);
+    }
+};
+
+// Prints the totals. Returns the exit code for main(): 1 if any check failed.
+inline int report() {
+    std::printf("%d checks, %d failures\n", checks, failures);
+    return failures ? 1 : 0;
+}
+
+#endif
@@ -12,47 +12,120 @@
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "VectorStatsConfig.h"
+#include "VectorStatsStorage.h"
+#include "VectorStatsLazy.h"
+#include "VectorStatsMedianHeap.h"
+#include "VectorStatsHistogram.h"
+#include "VectorStatsExtrema.h"
+#include "VectorStatsSortedShadow.h"
+#include "VectorStatsSorter.h"
+#include "VectorStatsQuantileSketch.h"
+#include "VectorStatsKernels.h"
+#include "VectorStatsMoments.h"
+#include "VectorStatsPolicy.h"
+#if defined(VECTORSTATS_PARALLEL)
+#include "VectorStatsParallel.h"
+#endif
+
+/**
+ * @struct VectorStatsSummary
+ * @brief All statistics of a buffer gathered by VectorStats::getSummary().
+ * @tparam T The data type of the buffer elements.
+ * @tparam Result The result type of the buffer's policy. Default = float.
+ */
+template <typename T, typename Result = float>
+struct VectorStatsSummary {
+    Result mean;     // Same as getAverage().
+    Result std_dev;  // Same as getStdDev().
+    T min;           // Smallest element.
+    T max;           // Largest element.
+    Result slope;    // Same as getSlope(). -1 if called on a sorted buffer.
+    int outliers;    // Same as getOutliers(deviations).
+    int left_skew;   // Same as getLeftSkew(deviations). -1 if called on a sorted buffer.
+};
 
 /**
  * @class VectorStats
  * @brief Class to create C++ vector buffers for fast median, average, and standard deviation.
  * @tparam T The data type of the vector and buffer elements.
+ * @tparam N Fixed buffer size. Default = 0 for a runtime sized buffer.
+ * @tparam Policy Accumulator and result types. Default = VectorStatsPolicy<> sums in double and returns float.
+ * - VectorStats<T, N> keeps its samples in a std::array. add() and the basic statistics never allocate.
+ * - Optional engines, the robust statistics, more than 8 quantiles and counting or radix sorts of
+ *   256 or more integers allocate their memory the first time they are used, on either kind of buffer.
+ * - Its size, midpoint and parity are compile-time constants.
+ * - With C++20 it can be evaluated in constant expressions.
+ * - VectorStats<int16_t, 0, VectorStatsPolicy<int64_t, double>> sums exactly and returns double.
  */
-template <typename T>
-class VectorStats {
+template <typename T, int N = 0, typename Policy = VectorStatsPolicy<>>
+class VectorStats : private VectorStatsStorage<T, N>, private Policy::instrumentation_type {
 public:
+    typedef typename Policy::accumulator_type Accumulator;
+    typedef typename Policy::result_type Result;
+    typedef typename Policy::instrumentation_type Instrumentation;
+
     /**
      * @brief Constructor for VectorStats.
      * @param max_buffer_size An integer value to initialize the maximum buffer size.
+     * - Only for runtime sized buffers (N = 0).
      */
-    VectorStats(int max_buffer_size);
+    VECTORSTATS_CONSTEXPR VectorStats(int max_buffer_size);
+
+    /**
+     * @brief Constructor for fixed-size VectorStats<T, N>.
+     * - Only for fixed size buffers (N > 0).
+     */
+    VECTORSTATS_CONSTEXPR VectorStats();
 
     /**
      * @brief Returns current size of buffer.
      * @return Current size of buffer as an integer.
      */
-    int size() const;
+    VECTORSTATS_CONSTEXPR int size() const;
 
     /**
      * @brief Resizes and zeroes buffer.
      * @param buffer_size An integer value for new buffer size.
      * - Buffer size must be less than or equal to max_buffer_size.
      * - Entering a buffer size greater than max_buffer_size will have no effect.
+     * - Fixed size buffers (N > 0) only accept N.
      * - Sets bufferFull() to false.
      */
-    void resize(int buffer_size);
+    VECTORSTATS_CONSTEXPR void resize(int buffer_size);
 
     /**
      * @brief Zeroes the buffer and sets .bufferFull() to false.
      */
-    void zeroBuffer();
+    VECTORSTATS_CONSTEXPR void zeroBuffer();
 
     // Add value to array
     /**
      * @brief Adds value to buffer replacing oldest data first if buffer is unsorted.
      * @param value A value of the <initalized data type> to be added to buffer.
      */
-    void add(T value);
+    VECTORSTATS_CONSTEXPR void add(T value);
+
+    /**
+     * @brief Adds a block of values as if add() was called for each one in order.
+     * - Copies into the buffer in at most two contiguous segments.
+     * - Flags and incremental moments are updated once per batch instead of once per value.
+     * - Only the newest size() values are kept when count is larger than the buffer.
+     * @param values Pointer to the first value to add.
+     * @param count Number of values to add.
+     */
+    VECTORSTATS_CONSTEXPR void addBatch(const T* values, size_t count);
+
+#if defined(VECTORSTATS_HAS_SPAN)
+    /**
+     * @brief Adds a block of values as if add() was called for each one in order.
+     * @param values A std::span of values to add.
+     */
+    VECTORSTATS_CONSTEXPR void addBatch(std::span<const T> values);
+#endif
 
     // Fill buffer with value.
     /**
@@ -60,29 +133,177 @@ public:
      * @param value A value of <initalized data type> to fill buffer.
      * Sets .bufferFull() to true.
      */
-    void fillBuffer(T value);
+    VECTORSTATS_CONSTEXPR void fillBuffer(T value);
 
     /**
      * @brief Calculates median of buffer data set.
-     * - Changes the order of values in buffer.
+     * - Changes the order of values in buffer unless rolling median is enabled.
      * - Sets .bufferFull() to false.
      * @return Median as <initalized data type>
      * - Odd-sized buffers are faster.
      * - Returns rounded average of center two numbers for even-sized buffers.
      */
-    T getMedian();
+    VECTORSTATS_CONSTEXPR T getMedian();
+
+    /**
+     * @brief Calculates several quantiles of buffer data set with one shared selection.
+     * - Every needed rank is found by recursive nth_element calls that reuse each partition.
+     * - Costs about O(n log k) for k quantiles instead of an O(n log n) sort.
+     * - Interpolates between the two nearest ranks (Hyndman and Fan type 7, same as NumPy's default).
+     * - Changes the order of values in buffer unless the histogram is enabled.
+     * - Sets .bufferFull() to false.
+     * @param quantiles Array of fractions from 0.0 (smallest) to 1.0 (largest). Clamped to that range.
+     * @param count Number of quantiles.
+     * @param results Array of count results to receive the quantiles in the same order.
+     */
+    VECTORSTATS_CONSTEXPR void getQuantiles(const double* quantiles, int count, Result* results);
+
+#if defined(VECTORSTATS_HAS_SPAN)
+    /**
+     * @brief Calculates several quantiles of buffer data set with one shared selection.
+     * @param quantiles A std::span of fractions from 0.0 to 1.0.
+     * @param results A std::span of at least quantiles.size() results.
+     */
+    VECTORSTATS_CONSTEXPR void getQuantiles(std::span<const double> quantiles, std::span<Result> results);
+#endif
+
+    /**
+     * @brief Enables or disables the rolling median.
+     * - Keeps an indexed two-heap next to the buffer that is updated by add().
+     * - add() becomes O(log n) and getMedian() becomes O(1).
+     * - getMedian() no longer changes the order of values in buffer.
+     * - Uses about (sizeof(T) + 8) extra bytes per element while enabled.
+     * @param enabled Boolean true to enable. Disabling frees the extra memory.
+     */
+    VECTORSTATS_CONSTEXPR void setRollingMedian(bool enabled);
+
+    /**
+     * @brief Enables or disables the counting histogram for integer types.
+     * - add() moves one count from the evicted value's bin to the new value's bin in O(1).
+     * - getMedian() and getSortedElement() walk the counts instead of sorting.
+     * - Neither method changes the order of values in buffer while enabled.
+     * - Values outside of the range are counted as min_value or max_value.
+     * - Uses 4 bytes per value in the range. A 12 bit ADC range is 16KB.
+     * - A reversed range or one wider than VectorStatsHistogram<T>::max_bins values leaves it disabled.
+     * @param enabled Boolean true to enable. Disabling frees the extra memory.
+     * @param min_value Smallest expected value. Default = 0.
+     * @param max_value Largest expected value. Default = 4095 for 12 bit analogRead, clamped to the largest T.
+     */
+    VECTORSTATS_CONSTEXPR void setHistogram(bool enabled, T min_value = 0,
+                                            T max_value = VectorStatsHistogram<T>::clampValue(4095));
+
+    /**
+     * @brief Enables or disables the sliding min and max tracker.
+     * - Keeps two monotonic deques of buffer slots that are updated by add() in amortized O(1).
+     * - getMin(), getMax() and getRange() become O(1).
+     * - Uses about 2 * (sizeof(T) + 4) extra bytes per element while enabled.
+     * @param enabled Boolean true to enable. Disabling frees the extra memory.
+     */
+    VECTORSTATS_CONSTEXPR void setRollingExtrema(bool enabled);
+
+    /**
+     * @brief Enables or disables the sorted shadow copy.
+     * - getSortedElement(), getMedian() and getQuantiles() read ranks from a sorted copy and leave the buffer in order.
+     * - add() only queues its replacement. The next rank query applies k queued adds in
+     *   O(k log n) searches and short shifts, or one O(n + k log k) merge, instead of an O(n log n) sort.
+     * - Uses about 3 * sizeof(T) extra bytes per element while enabled.
+     * @param enabled Boolean true to enable. Disabling frees the extra memory.
+     */
+    VECTORSTATS_CONSTEXPR void setSortedShadow(bool enabled);
+
+    /**
+     * @brief Gets the smallest value in buffer without changing the order of values.
+     * @return Min as <initalized data type>. O(1) when rolling extrema are enabled, otherwise one pass.
+     */
+    VECTORSTATS_CONSTEXPR T getMin() const;
+
+    /**
+     * @brief Gets the largest value in buffer without changing the order of values.
+     * @return Max as <initalized data type>. O(1) when rolling extrema are enabled, otherwise one pass.
+     */
+    VECTORSTATS_CONSTEXPR T getMax() const;
+
+    /**
+     * @brief Gets the peak to peak range of buffer, getMax() - getMin().
+     * @return Range as <initalized data type>.
+     */
+    VECTORSTATS_CONSTEXPR T getRange() const;
 
     /**
      * @brief Calculates the average of buffer data set.
-     * @return Average as a float.
+     * @return Average as the policy Result type, float by default.
+     * - O(1) when incremental moments are enabled.
      */
-    float getAverage() const;
+    VECTORSTATS_CONSTEXPR Result getAverage() const;
 
     /**
      * @brief Calculates the population standard deviation of buffer data set.
-     * @return Standard Deviation as a float.
+     * @return Standard Deviation as the policy Result type, float by default.
+     * - O(1) when incremental moments are enabled.
+     */
+    VECTORSTATS_CONSTEXPR Result getStdDev() const;
+
+    /**
+     * @brief Enables or disables incremental moments.
+     * - add() swaps the evicted value for the new one in a running sum and sum of squares.
+     * - getAverage(), getStdDev(), getOutliers() and getSlope() no longer re-sum the whole buffer.
+     * - Sums are kept relative to a shift value to avoid cancellation.
+     * - 8 and 16 bit integer types are summed exactly in int64_t.
+     * - Other types re-normalize from the buffer once every buffer size adds to bound drift.
+     * @param enabled Boolean true to enable.
+     */
+    VECTORSTATS_CONSTEXPR void setIncrementalMoments(bool enabled);
+
+    /**
+     * @brief Enables or disables the streaming quantile sketch.
+     * - add() and addBatch() also feed every value into a KLL sketch in O(log k) amortized.
+     * - The sketch covers every value added since it was enabled, not just the buffer.
+     * - Rank error is about 1.7 / k of the number of values. Uses about 3k values of memory.
+     * @param enabled Boolean true to enable. Enabling starts an empty sketch. Disabling frees its memory.
+     * @param k Sketch accuracy. Default = 200.
+     * @param seed Seed of the sketch's compaction coins. Default = 0 picks a different seed for every sketch.
+     */
+    VECTORSTATS_CONSTEXPR void setQuantileSketch(bool enabled, int k = 200, uint32_t seed = 0);
+
+    /**
+     * @brief Estimates a quantile of every value added since the sketch was enabled.
+     * @param quantile Fraction from 0.0 (smallest) to 1.0 (largest). 0.5 is the median.
+     * @return Estimated value as <initalized data type>. Returns -1 if the sketch is disabled or empty.
+     */
+    VECTORSTATS_CONSTEXPR T getStreamQuantile(double quantile) const;
+
+    /**
+     * @brief Gets the streaming quantile sketch for merging with sketches of other buffers.
      */
-    float getStdDev() const;
+    const VectorStatsQuantileSketch<T>& getQuantileSketch() const;
+
+    /**
+     * @brief Gets the instrumentation chosen by the policy.
+     * - With VectorStatsCounters call snapshot() on it to read call counts, ticks and sort events.
+     * - The default VectorStatsNoInstrumentation holds nothing.
+     */
+    VECTORSTATS_CONSTEXPR Instrumentation& getInstrumentation();
+    VECTORSTATS_CONSTEXPR const Instrumentation& getInstrumentation() const;
+
+    /**
+     * @brief Exports count, mean, M2, min, max and regression sums of the buffer.
+     * - Merge the result with moments from other buffers, threads or hosts.
+     * - x positions follow insertion order from x_start at the oldest element, like getSlope().
+     * @param x_start x position of the oldest element. Default = 1.
+     * @return VectorStatsMoments of the whole buffer.
+     */
+    VECTORSTATS_CONSTEXPR VectorStatsMoments getMoments(double x_start = 1) const;
+
+#if defined(VECTORSTATS_PARALLEL)
+    /**
+     * @brief Runs statistics on a thread pool for buffers of at least parallel->threshold() elements.
+     * - getAverage(), getStdDev(), getOutliers(), getSlope(), getMoments() and getMedian() split the buffer into chunks.
+     * - getMedian() no longer changes the order of values in buffer when it runs in parallel.
+     * - The pool can be shared by many buffers but only used by one thread at a time.
+     * @param parallel Pointer to a VectorStatsParallel pool. nullptr to run serially again.
+     */
+    void setParallel(VectorStatsParallel* parallel);
+#endif
 
     /**
      * @brief Gets element from unsorted buffer.
@@ -92,67 +313,172 @@ public:
      * - Returns -1 if element is out of range.
      * - Do not use after calling getSortedElement() or getMedian().
      */
-    T getElement(int element) const;
+    VECTORSTATS_CONSTEXPR T getElement(int element) const;
 
     /**
      * @brief Gets element from unsorted buffer.
      * @param element An integer representing the index value.
      * @return Element as <initalized data type>
      * - Returns -1 if element is out of range.
-     * Changes the order of values in buffer.
+     * - 8, 16 and 32 bit integer buffers of 256 elements or more are sorted in O(n) by counting or radix sort.
+     * Changes the order of values in buffer unless the histogram or sorted shadow is enabled.
      */
-    T getSortedElement(int element);
+    VECTORSTATS_CONSTEXPR T getSortedElement(int element);
 
     /**
      * @brief Checks state of buffer.
      * @return Boolean true if buffer is full.
      */
-    bool bufferFull() const;
+    VECTORSTATS_CONSTEXPR bool bufferFull() const;
 
     /**
      * @brief Toggles .bufferFull() flag to false.
      */
-    void setBufferFullFalse();
+    VECTORSTATS_CONSTEXPR void setBufferFullFalse();
 
     /**
      * @brief Counts the number of outliers in the buffer.
      * @param deviations An integer value of standard deviations from mean. Default = 2.
      * @return Outlier count as an integer.
      */
-    int getOutliers(int8_t deviations = 2) const;
+    VECTORSTATS_CONSTEXPR int getOutliers(int8_t deviations = 2) const;
 
     /**
      * @brief Counts the number of beginning elements that are outliers.
      * - The standard deviation and average of the right half of the buffer is used
      * - to determine the skew of the left half of the buffer.
+     * - Halves follow insertion order like getSlope(). The left half starts at the oldest element.
      * - Counts left elements that are > (n deviations * right stdDev) from the right mean.
      * - A negative skew count indicates the left side is lower than the right side average.
      * @param deviations An integer value of standard deviations from mean. Default = 2.
      * @return Skew count of left elements deviating from right mean as an integer.
      * - Returns -1 if called on a sorted buffer.
      */
-    int getLeftSkew(int8_t deviations = 2) const;
+    VECTORSTATS_CONSTEXPR int getLeftSkew(int8_t deviations = 2) const;
 
     /**
      * @brief Calculates slope using linear regression.
      * @return Slope as a float. Can be negative.
      * - Returns -1 if called on a sorted buffer.
-     * - x values are sequence from 1 to buffer size.
+     * - x values are sequence from 1 to buffer size in insertion order, starting at the oldest element.
      * - y values are unaltered data set.
+     * - O(1) when incremental moments are enabled.
+     */
+    VECTORSTATS_CONSTEXPR Result getSlope() const;
+
+    /**
+     * @brief Calculates the median absolute deviation, the median of |value - median|.
+     * - Works on a scratch copy with partial selection. Does not change the order of values in buffer.
+     * - Multiply by 1.4826 to estimate the standard deviation of normally distributed data.
+     * @return MAD as a float.
+     */
+    VECTORSTATS_CONSTEXPR Result getMAD();
+
+    /**
+     * @brief Counts outliers with the Hampel identifier.
+     * - Outliers are further than threshold * 1.4826 * MAD from the median.
+     * - Unlike getOutliers(), the outliers themselves cannot pull the center or the spread.
+     * - Does not change the order of values in buffer.
+     * @param threshold Number of scaled MADs from the median. Default = 3.
+     * @return Outlier count as an integer.
+     */
+    VECTORSTATS_CONSTEXPR int getHampelOutliers(float threshold = 3);
+
+    /**
+     * @brief Calculates the mean after dropping the smallest and largest values.
+     * - Drops (int)(proportion * size) values from each end using partial selection on a scratch copy.
+     * - Does not change the order of values in buffer.
+     * @param proportion Fraction dropped from each end, 0.0 to under 0.5. Default = 0.1.
+     * @return Trimmed mean as a float.
+     */
+    VECTORSTATS_CONSTEXPR Result getTrimmedMean(float proportion = 0.1);
+
+    /**
+     * @brief Calculates the mean after clamping the smallest and largest values.
+     * - Same as getTrimmedMean() except the dropped values count as the nearest kept value.
+     * - Does not change the order of values in buffer.
+     * @param proportion Fraction clamped at each end, 0.0 to under 0.5. Default = 0.1.
+     * @return Winsorized mean as a float.
      */
-    float getSlope() const;
+    VECTORSTATS_CONSTEXPR Result getWinsorizedMean(float proportion = 0.1);
+
+    /**
+     * @brief Calculates every statistic at once with the fewest passes over the buffer.
+     * - One pass gathers sums, squares, min, max and the slope sums for both halves.
+     * - A second pass counts outliers. Left skew only reads the leading outliers.
+     * - Cheaper than calling getAverage(), getStdDev(), getOutliers(), getSlope() and getLeftSkew().
+     * @param deviations An integer value of standard deviations from mean. Default = 2.
+     * @return VectorStatsSummary with mean, std_dev, min, max, slope, outliers and left_skew.
+     */
+    VECTORSTATS_CONSTEXPR VectorStatsSummary<T, Result> getSummary(int8_t deviations = 2) const;
 
 private:
-    std::vector<T> _data_array;
-    const int _max_buffer_size;
-    int _size;
-    int _mid_element;
-    bool _odd_parity;
+    typedef VectorStatsStorage<T, N> Storage;
+    typedef typename Instrumentation::Scope Probe;
+    using Storage::_data_array;
+    using Storage::_max_buffer_size;
+    using Storage::_size;          // Compile-time constant when N > 0.
+    using Storage::_mid_element;   // Compile-time constant when N > 0.
+    using Storage::_odd_parity;    // Compile-time constant when N > 0.
+    using Storage::_resizeStorage;
+
     int _element;
     bool _buffer_full;
     bool _data_sorted;   // Is data sorted smallest to largest?
     bool _data_ordered;  // Is data in original order?
+    bool _rolling_median;
+    bool _rolling_extrema;
+    bool _histogram;
+    bool _sorted_shadow;
+    bool _incremental_moments;
+    bool _quantile_sketch;
 
+    // Small integers cannot drift, everything else is summed in double.
+    typedef typename std::conditional<std::is_integral<T>::value && sizeof(T) <= 2,
+        int64_t, double>::type MomentSum;
+
+    // State of the optional engines and scratch memory of the robust statistics.
+    // Allocated the first time one of them is used, so a plain buffer only holds its samples.
+    struct Extensions {
+        VectorStatsMedianHeap<T> median_heap;
+        VectorStatsExtrema<T> extrema;
+        VectorStatsHistogram<T> histogram_bins;
+        T histogram_min = 0;
+        T histogram_max = 0;
+        VectorStatsSortedShadow<T> shadow;
+        T moment_shift = 0;
+        MomentSum moment_sum = 0;       // Sum of (value - moment_shift).
+        MomentSum moment_sum_sq = 0;    // Sum of (value - moment_shift)^2.
+        MomentSum moment_weighted = 0;  // Sum of x * (value - moment_shift) with x = 1 at the oldest value.
+        int moment_updates = 0;         // Adds since the last re-normalization.
+        VectorStatsQuantileSketch<T> sketch;
+        std::vector<T> scratch;          // Robust statistics copy.
+        VectorStatsSorter<T> sorter;     // Full sorts for getSortedElement(). Keeps its scratch.
+        std::vector<Result> deviations;  // |value - median| for MAD and Hampel, kept at the policy's precision.
+#if defined(VECTORSTATS_PARALLEL)
+        std::vector<T> parallel_scratch;  // Median band, reused between calls.
+#endif
+    };
+    VectorStatsLazy<Extensions> _extensions;
+
+#if defined(VECTORSTATS_PARALLEL)
+    VectorStatsParallel* _parallel = nullptr;
+#endif
+    VECTORSTATS_CONSTEXPR bool _useParallel() const;
+    static const VectorStatsQuantileSketch<T>& _emptySketch();
+
+    VECTORSTATS_CONSTEXPR T _midpoint(T left_mid, T right_mid) const;
+    VECTORSTATS_CONSTEXPR double _scratchMedian();
+    VECTORSTATS_CONSTEXPR double _deviationMedian(double center);
+    VECTORSTATS_CONSTEXPR int _trimSelect(float proportion);
+    VECTORSTATS_CONSTEXPR int _leftSkewCount(float mean, float stdDev, int8_t deviations) const;
+    VECTORSTATS_CONSTEXPR void _rebuildTrackers();
+    VECTORSTATS_CONSTEXPR void _rebuildMoments();
+    VECTORSTATS_CONSTEXPR void _updateMoments(T old_value, T new_value);
+    VECTORSTATS_CONSTEXPR void _writeSegment(int start, const T* values, int count, int batch_offset, MomentSum& weighted_delta);
+    VECTORSTATS_CONSTEXPR MomentSum _shiftedWeightedSum(const T* data, int count) const;
+    VECTORSTATS_CONSTEXPR void _chronologicalSums(double& total, double& weighted) const;
+    VECTORSTATS_CONSTEXPR void _multiSelect(int first, int last, const int* ranks, int rank_count);
 };
 
 
@@ -160,50 +486,81 @@ private:
 // VectorStats Class Implementation
 ////////////////////////////////////////
 
-template <typename T>
-VectorStats<T>::VectorStats(int max_buffer_size)
-    : _data_array(max_buffer_size),  // Preallocates memory.
-      _max_buffer_size(max_buffer_size),
-      _size(max_buffer_size),
-      _mid_element(max_buffer_size / 2),
-      _odd_parity(max_buffer_size % 2),
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR VectorStats<T, N, Policy>::VectorStats(int max_buffer_size)
+    : Storage(max_buffer_size),
+      _element(0),
+      _buffer_full(false),
+      _data_sorted(false),
+      _data_ordered(true),
+      _rolling_median(false),
+      _rolling_extrema(false),
+      _histogram(false),
+      _sorted_shadow(false),
+      _incremental_moments(false),
+      _quantile_sketch(false) {}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR VectorStats<T, N, Policy>::VectorStats()
+    : Storage(),
       _element(0),
       _buffer_full(false),
       _data_sorted(false),
-      _data_ordered(true) {}
+      _data_ordered(true),
+      _rolling_median(false),
+      _rolling_extrema(false),
+      _histogram(false),
+      _sorted_shadow(false),
+      _incremental_moments(false),
+      _quantile_sketch(false) {}
 
-template <typename T>
-int VectorStats<T>::size() const {
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR int VectorStats<T, N, Policy>::size() const {
     return _size;
 }
 
-// Resizes buffer to any size up to max_buffer_size.
-// Max size of vector must be preallocated on microcontrollers.
-template <typename T>
-void VectorStats<T>::resize(int buffer_size) {
-    if (buffer_size <= _max_buffer_size) {
-        _size = buffer_size;
-        _mid_element = buffer_size / 2;
-        _odd_parity = buffer_size % 2;
-        _data_array.resize(buffer_size);
+// Fixed size buffers only accept their own size.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::resize(int buffer_size) {
+    if (_resizeStorage(buffer_size)) {
         zeroBuffer();
     }
 }
 
-template <typename T>
-void VectorStats<T>::zeroBuffer() {
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::zeroBuffer() {
     std::fill(_data_array.begin(), _data_array.end(), 0);
     _element = 0;
     _buffer_full = false;
     _data_sorted = false;
     _data_ordered = true;
+    _rebuildTrackers();
 }
 
 // Does not block if buffer is full.
 // Will behave circularly if .bufferFull() is ignored.
-template <typename T>
-void VectorStats<T>::add(T value) {
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::add(T value) {
+    Probe probe(*this, VectorStatsMethod::add);
+    Instrumentation::touched(VectorStatsMethod::add, 1);
+    if (_rolling_median) {
+        _extensions->median_heap.replace(_element, value);
+    }
+    if (_rolling_extrema) {
+        _extensions->extrema.replace(_element, value);
+    }
+    T old_value = _data_array[_element];
     _data_array[_element] = value;
+    if (_histogram) {
+        _extensions->histogram_bins.replace(old_value, value);
+    }
+    if (_sorted_shadow) {
+        _extensions->shadow.replace(old_value, value);
+    }
+    if (_quantile_sketch) {
+        _extensions->sketch.add(value);
+    }
+    bool reordered = false;
     if (_element < _size - 1) {
         _element++;
         _buffer_full = false;
@@ -212,46 +569,152 @@ void VectorStats<T>::add(T value) {
         _element = 0;
         _buffer_full = true;
         _data_sorted = false;
+        reordered = !_data_ordered;
         _data_ordered = true;
     }
+
+    // The weighted sum follows insertion order, so it restarts once a reordered buffer is ordered again.
+    if (_incremental_moments) {
+        if (reordered) {
+            _rebuildMoments();
+        } else {
+            _updateMoments(old_value, value);
+        }
+    }
 }
 
-template <typename T>
-void VectorStats<T>::fillBuffer(T value) {
+// Same end state as calling add() count times.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::addBatch(const T* values, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    Probe probe(*this, VectorStatsMethod::addBatch);
+    Instrumentation::touched(VectorStatsMethod::addBatch, count < (size_t)_size ? (int)count : _size);
+    if (_quantile_sketch) {
+        for (size_t i = 0; i < count; ++i) {
+            _extensions->sketch.add(values[i]);
+        }
+    }
+
+    // Older values of a long batch would be overwritten within the same batch.
+    size_t skip = count > (size_t)_size ? count - _size : 0;
+    int start = (int)((_element + skip) % _size);
+    int kept = (int)(count - skip);
+    int first = kept < _size - start ? kept : _size - start;
+    if (skip > 0 && _rolling_extrema) {
+        // Writing starts past the oldest slot, so restart the deques from the first slot written.
+        _extensions->extrema.build(_data_array.data(), _size, start);
+    }
+    MomentSum old_total = _incremental_moments ? _extensions->moment_sum : 0;
+    MomentSum weighted_delta = 0;
+    _writeSegment(start, values + skip, first, 0, weighted_delta);
+    if (kept > first) {
+        _writeSegment(0, values + skip + first, kept - first, first, weighted_delta);
+    }
+
+    bool wrapped = _element + count >= (size_t)_size;
+    bool reordered = wrapped && !_data_ordered;
+    _element = (int)((_element + count) % _size);
+    _buffer_full = (_element == 0);
+    _data_sorted = false;
+    if (wrapped) {
+        _data_ordered = true;
+    }
+
+    if (_incremental_moments) {
+        if (!std::is_integral<MomentSum>::value) {
+            _extensions->moment_updates += kept;
+        }
+        if (skip > 0 || reordered || _extensions->moment_updates >= _size) {
+            _rebuildMoments();
+        } else {
+            // Same as kept calls of W = W - S + n * new, with S changing by (new - old) after each call.
+            MomentSum change = _extensions->moment_sum - old_total;
+            _extensions->moment_weighted += weighted_delta - (MomentSum)kept * old_total - (MomentSum)(kept - 1) * change;
+        }
+    }
+}
+
+#if defined(VECTORSTATS_HAS_SPAN)
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::addBatch(std::span<const T> values) {
+    addBatch(values.data(), values.size());
+}
+#endif
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::fillBuffer(T value) {
     std::fill(_data_array.begin(), _data_array.end(), value);
     _data_ordered = true;
     _data_sorted = false;
     _buffer_full = true;
+    _rebuildTrackers();
 }
 
 // Uses the nth_element algorithm to limit cost of sorting all data.
-template <typename T>
-T VectorStats<T>::getMedian() {
+// The rolling median and histogram read their own structures instead and leave the buffer untouched.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::getMedian() {
+    Probe probe(*this, VectorStatsMethod::getMedian);
     T median;
     T right_mid, left_mid;
 
+    if (_rolling_median) {
+        right_mid = _extensions->median_heap.rightMid();
+        median = _odd_parity ? right_mid : _midpoint(_extensions->median_heap.leftMid(), right_mid);
+        _buffer_full = false;
+        return median;
+    }
+
+    if (_histogram) {
+        right_mid = _extensions->histogram_bins.rank(_mid_element);
+        median = _odd_parity ? right_mid : _midpoint(_extensions->histogram_bins.rank(_mid_element - 1), right_mid);
+        _buffer_full = false;
+        return median;
+    }
+
+    if (_sorted_shadow) {
+        Instrumentation::sortedHit(VectorStatsMethod::getMedian);
+        _extensions->shadow.flush(_data_array.data());
+        right_mid = _extensions->shadow.rank(_mid_element);
+        median = _odd_parity ? right_mid : _midpoint(_extensions->shadow.rank(_mid_element - 1), right_mid);
+        _buffer_full = false;
+        return median;
+    }
+
+#if defined(VECTORSTATS_PARALLEL)
+    if (_useParallel() && !_data_sorted) {
+        Instrumentation::touched(VectorStatsMethod::getMedian, _size);
+        _parallel->median(_data_array.data(), _size, _extensions.get().parallel_scratch, left_mid, right_mid);
+        median = _odd_parity ? right_mid : _midpoint(left_mid, right_mid);
+        _buffer_full = false;
+        return median;
+    }
+#endif
+
     if (!_data_sorted) {
+        Instrumentation::sortedMiss(VectorStatsMethod::getMedian, false);
+        Instrumentation::touched(VectorStatsMethod::getMedian, _size);
         std::nth_element(_data_array.begin(), _data_array.begin() + _mid_element, _data_array.end());
         right_mid = _data_array[_mid_element];
         if (_odd_parity) {
             median = right_mid;
         } else {
             // Handle even parity.
-            std::nth_element(_data_array.begin(), _data_array.begin() + _mid_element - 1, _data_array.end());
-            left_mid = _data_array[_mid_element - 1];
-            if (std::is_integral<T>::value) {
-                median = round((right_mid + left_mid) / 2);
-            } else {
-            median = (right_mid + left_mid);  // Don't round for floating point types
-            }
+            // Everything left of _mid_element is now <= right_mid so the left middle is their max.
+            left_mid = *std::max_element(_data_array.begin(), _data_array.begin() + _mid_element);
+            median = _midpoint(left_mid, right_mid);
+        }
+        if (_rolling_extrema) {
+            _extensions->extrema.build(_data_array.data(), _size, _element);
         }
     } else {
+        Instrumentation::sortedHit(VectorStatsMethod::getMedian);
         if (_odd_parity) {
             median = _data_array[_mid_element];
-        } else if (std::is_integral<T>::value) {
-            median = round((_data_array[_mid_element - 1] + _data_array[_mid_element]) / 2);
         } else {
-            median = (_data_array[_mid_element - 1] + _data_array[_mid_element] / 2);
+            median = _midpoint(_data_array[_mid_element - 1], _data_array[_mid_element]);
         }
     }
 
@@ -260,38 +723,289 @@ T VectorStats<T>::getMedian() {
     return median;
 }
 
-// Can hold up to 6-7 sig figs.
-template <typename T>
-float VectorStats<T>::getAverage() const {
-    float sum = std::accumulate(_data_array.begin(), _data_array.end(), 0.0);
-    return sum / _size;
+// Type 7 places quantile q at sorted position q * (size - 1) and interpolates between its neighbours.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::getQuantiles(const double* quantiles, int count, Result* results) {
+    Probe probe(*this, VectorStatsMethod::getQuantiles);
+    // Up to 8 quantiles keep their ranks on the stack.
+    int stack_ranks[16];
+    std::vector<int> heap_ranks;
+    int* ranks = stack_ranks;
+    if (count > 8) {
+        heap_ranks.resize(2 * count);
+        ranks = heap_ranks.data();
+    }
+    int rank_count = 0;
+    for (int i = 0; i < count; ++i) {
+        double q = quantiles[i] < 0 ? 0 : (quantiles[i] > 1 ? 1 : quantiles[i]);
+        double position = q * (_size - 1);
+        int low = (int)position;
+        ranks[rank_count++] = low;
+        ranks[rank_count++] = low + 1 < _size ? low + 1 : low;
+    }
+    std::sort(ranks, ranks + rank_count);
+    rank_count = (int)(std::unique(ranks, ranks + rank_count) - ranks);
+
+    if (_sorted_shadow) {
+        Instrumentation::sortedHit(VectorStatsMethod::getQuantiles);
+        _extensions->shadow.flush(_data_array.data());
+    } else if (_data_sorted) {
+        Instrumentation::sortedHit(VectorStatsMethod::getQuantiles);
+    } else if (!_histogram) {
+        Instrumentation::sortedMiss(VectorStatsMethod::getQuantiles, false);
+        Instrumentation::touched(VectorStatsMethod::getQuantiles, _size);
+        _multiSelect(0, _size, ranks, rank_count);
+        _data_ordered = false;
+        if (_rolling_median) {
+            _extensions->median_heap.build(_data_array.data(), _size);
+        }
+        if (_rolling_extrema) {
+            _extensions->extrema.build(_data_array.data(), _size, _element);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        double q = quantiles[i] < 0 ? 0 : (quantiles[i] > 1 ? 1 : quantiles[i]);
+        double position = q * (_size - 1);
+        int low = (int)position;
+        int high = low + 1 < _size ? low + 1 : low;
+        double low_value = _histogram ? _extensions->histogram_bins.rank(low) : (_sorted_shadow ? _extensions->shadow.rank(low) : _data_array[low]);
+        double high_value = _histogram ? _extensions->histogram_bins.rank(high) : (_sorted_shadow ? _extensions->shadow.rank(high) : _data_array[high]);
+        results[i] = low_value + (position - low) * (high_value - low_value);
+    }
+    _buffer_full = false;
+}
+
+#if defined(VECTORSTATS_HAS_SPAN)
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::getQuantiles(std::span<const double> quantiles, std::span<Result> results) {
+    getQuantiles(quantiles.data(), (int)std::min(quantiles.size(), results.size()), results.data());
+}
+#endif
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::setRollingMedian(bool enabled) {
+    _rolling_median = enabled;
+    if (enabled) {
+        _extensions.get().median_heap.build(_data_array.data(), _size);
+    } else if (_extensions) {
+        _extensions->median_heap.clear();
+    }
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::setRollingExtrema(bool enabled) {
+    _rolling_extrema = enabled;
+    if (enabled) {
+        _extensions.get().extrema.build(_data_array.data(), _size, _element);
+    } else if (_extensions) {
+        _extensions->extrema.clear();
+    }
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::setSortedShadow(bool enabled) {
+    _sorted_shadow = enabled;
+    if (enabled) {
+        _extensions.get().shadow.build(_data_array.data(), _size);
+    } else if (_extensions) {
+        _extensions->shadow.clear();
+    }
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::getMin() const {
+    if (_rolling_extrema) {
+        return _extensions->extrema.min();
+    }
+    T low = _data_array[0], high = _data_array[0];
+    VectorStatsKernels<T>::minMax(_data_array.data(), _size, low, high);
+    return low;
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::getMax() const {
+    if (_rolling_extrema) {
+        return _extensions->extrema.max();
+    }
+    T low = _data_array[0], high = _data_array[0];
+    VectorStatsKernels<T>::minMax(_data_array.data(), _size, low, high);
+    return high;
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::getRange() const {
+    if (_rolling_extrema) {
+        return _extensions->extrema.max() - _extensions->extrema.min();
+    }
+    T low = _data_array[0], high = _data_array[0];
+    VectorStatsKernels<T>::minMax(_data_array.data(), _size, low, high);
+    return high - low;
+}
+
+// The sum is converted once at the end. A float Result holds 6-7 sig figs.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::Result VectorStats<T, N, Policy>::getAverage() const {
+    Probe probe(*this, VectorStatsMethod::getAverage);
+    if (_incremental_moments) {
+        return _extensions->moment_shift + (double)_extensions->moment_sum / _size;
+    }
+#if defined(VECTORSTATS_PARALLEL)
+    if (_useParallel()) {
+        Instrumentation::touched(VectorStatsMethod::getAverage, _size);
+        return (double)_parallel->template sum<T, Policy>(_data_array.data(), _size) / _size;
+    }
+#endif
+    Instrumentation::touched(VectorStatsMethod::getAverage, _size);
+    Accumulator sum = Policy::sum(_data_array.data(), _size);
+    return (double)sum / _size;
 }
 
 // Gets population standard deviation.
-// Uses 4 byte floats yielding 6-7 sig figs.
-template <typename T>
-float VectorStats<T>::getStdDev() const {
-    float sum = std::accumulate(_data_array.begin(), _data_array.end(), 0.0);
-    float mean = sum / _size;
-    float variance = std::inner_product(_data_array.begin(), _data_array.end(), _data_array.begin(), 0.0,
-        std::plus<float>(), [mean](float x, float y) { return (x - mean) * (y - mean); }) / _size;
+// The mean comes from the policy sum, the squared deviations are summed in double.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::Result VectorStats<T, N, Policy>::getStdDev() const {
+    Probe probe(*this, VectorStatsMethod::getStdDev);
+    if (_incremental_moments) {
+        double shifted_mean = (double)_extensions->moment_sum / _size;
+        double variance = (double)_extensions->moment_sum_sq / _size - shifted_mean * shifted_mean;
+        return variance > 0 ? std::sqrt(variance) : 0;
+    }
+#if defined(VECTORSTATS_PARALLEL)
+    if (_useParallel()) {
+        Instrumentation::touched(VectorStatsMethod::getStdDev, _size);
+        return _parallel->moments(_data_array.data(), _size).getStdDev();
+    }
+#endif
+    Instrumentation::touched(VectorStatsMethod::getStdDev, 2 * _size);
+    double mean = (double)Policy::sum(_data_array.data(), _size) / _size;
+    double variance = VectorStatsKernels<T>::sumSquaredDeviations(_data_array.data(), _size, mean) / _size;
     return std::sqrt(variance);
 }
 
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::setHistogram(bool enabled, T min_value, T max_value) {
+    static_assert(std::is_integral<T>::value, "The histogram needs an integer data type.");
+    _histogram = enabled && VectorStatsHistogram<T>::fits(min_value, max_value);
+    if (_histogram) {
+        Extensions& extensions = _extensions.get();
+        extensions.histogram_min = min_value;
+        extensions.histogram_max = max_value;
+        extensions.histogram_bins.build(_data_array.data(), _size, min_value, max_value);
+    } else if (_extensions) {
+        _extensions->histogram_bins.clear();
+    }
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::setIncrementalMoments(bool enabled) {
+    _incremental_moments = enabled;
+    if (enabled) {
+        _rebuildMoments();
+    }
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::setQuantileSketch(bool enabled, int k, uint32_t seed) {
+    _quantile_sketch = enabled;
+    if (enabled) {
+        _extensions.get().sketch = VectorStatsQuantileSketch<T>(k, seed);
+    } else if (_extensions) {
+        _extensions->sketch.clear();
+    }
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::getStreamQuantile(double quantile) const {
+    return _quantile_sketch ? _extensions->sketch.getQuantile(quantile) : -1;
+}
+
+template <typename T, int N, typename Policy>
+const VectorStatsQuantileSketch<T>& VectorStats<T, N, Policy>::getQuantileSketch() const {
+    return _extensions ? _extensions->sketch : _emptySketch();
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::Instrumentation& VectorStats<T, N, Policy>::getInstrumentation() {
+    return *this;
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR const typename VectorStats<T, N, Policy>::Instrumentation& VectorStats<T, N, Policy>::getInstrumentation() const {
+    return *this;
+}
+
+// The oldest run starts at _element and the newest run continues from element 0.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR VectorStatsMoments VectorStats<T, N, Policy>::getMoments(double x_start) const {
+    const T* data = _data_array.data();
+    int oldest_count = _size - _element;
+#if defined(VECTORSTATS_PARALLEL)
+    if (_useParallel()) {
+        VectorStatsMoments moments = _parallel->moments(data + _element, oldest_count);
+        moments.mean_x += x_start - 1;
+        if (_element > 0) {
+            VectorStatsMoments newest = _parallel->moments(data, _element);
+            newest.mean_x += x_start + oldest_count - 1;
+            moments.merge(newest);
+        }
+        return moments;
+    }
+#endif
+    VectorStatsMoments moments = VectorStatsMoments::fromData(data + _element, oldest_count, x_start);
+    moments.merge(VectorStatsMoments::fromData(data, _element, x_start + oldest_count));
+    return moments;
+}
+
+#if defined(VECTORSTATS_PARALLEL)
+template <typename T, int N, typename Policy>
+void VectorStats<T, N, Policy>::setParallel(VectorStatsParallel* parallel) {
+    _parallel = parallel;
+    if (!parallel && _extensions) {
+        std::vector<T>().swap(_extensions->parallel_scratch);
+    }
+}
+#endif
+
 // Returns -1 for all values if called after getSortedElement() or getMedian()
-template <typename T>
-T VectorStats<T>::getElement(int element) const {
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::getElement(int element) const {
     if (_data_ordered && element >= 0 && element < _size) {
         return _data_array[element];
     } else { return -1; }
 }
 
-template <typename T>
-T VectorStats<T>::getSortedElement(int element) {
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::getSortedElement(int element) {
+    Probe probe(*this, VectorStatsMethod::getSortedElement);
+    if (_histogram) {
+        if (element >= 0 && element < _size) {
+            return _extensions->histogram_bins.rank(element);
+        } else { return -1; }
+    }
+
+    if (_sorted_shadow) {
+        Instrumentation::sortedHit(VectorStatsMethod::getSortedElement);
+        _extensions->shadow.flush(_data_array.data());
+        if (element >= 0 && element < _size) {
+            return _extensions->shadow.rank(element);
+        } else { return -1; }
+    }
+
     if (!_data_sorted) {
-        std::sort(_data_array.begin(), _data_array.end());
+        Instrumentation::sortedMiss(VectorStatsMethod::getSortedElement, true);
+        Instrumentation::touched(VectorStatsMethod::getSortedElement, _size);
+        // Sorts that need no scratch memory leave the extensions unallocated.
+        if (VectorStatsSorter<T>::usesScratch(_size)) {
+            _extensions.get().sorter.sort(_data_array.data(), _size);
+        } else {
+            std::sort(_data_array.begin(), _data_array.end());
+        }
         _data_sorted = true;
         _data_ordered = false;
+        _rebuildTrackers();
+    } else {
+        Instrumentation::sortedHit(VectorStatsMethod::getSortedElement);
     }
 
     if (element >= 0 && element < _size) {
@@ -299,44 +1013,84 @@ T VectorStats<T>::getSortedElement(int element) {
     } else { return -1; }
 }
 
-template <typename T>
-bool VectorStats<T>::bufferFull() const {
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR bool VectorStats<T, N, Policy>::bufferFull() const {
     return _buffer_full;
 }
 
-template <typename T>
-void VectorStats<T>::setBufferFullFalse() {
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::setBufferFullFalse() {
     _element = 0;
     _buffer_full = false;
     _data_sorted = false;
     _data_ordered = false;
+    // The next add() overwrites element 0, so the extrema must treat it as the oldest.
+    if (_rolling_extrema) {
+        _extensions->extrema.build(_data_array.data(), _size, _element);
+    }
 }
 
-template <typename T>
-int VectorStats<T>::getOutliers(int8_t deviations) const {
-    float stdDev = getStdDev();
-    float mean = getAverage();
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR int VectorStats<T, N, Policy>::getOutliers(int8_t deviations) const {
+    Probe probe(*this, VectorStatsMethod::getOutliers);
+    Instrumentation::touched(VectorStatsMethod::getOutliers, _size);
+    Result stdDev = getStdDev();
+    Result mean = getAverage();
+    Result limit = stdDev * deviations;
 
-    int outlier_count = 0;
-    for (T value : _data_array) {
-        if (std::abs(value - mean) > (stdDev * deviations)) {
-            outlier_count++;
-        }
+    // Outside of mean +/- limit is the same test as std::abs(value - mean) > limit.
+#if defined(VECTORSTATS_PARALLEL)
+    if (_useParallel()) {
+        return _parallel->countOutside(_data_array.data(), _size, mean - limit, mean + limit);
     }
-    //int outlier_count = std::count_if(_data_array.begin(), _data_array.end(), [mean, stdDev, deviations](int n){ return std::abs(n - mean) > (stdDev * deviations); });
-    return outlier_count;
+#endif
+    return VectorStatsKernels<T>::countOutside(_data_array.data(), _size, mean - limit, mean + limit);
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::Result VectorStats<T, N, Policy>::getMAD() {
+    return _deviationMedian(_scratchMedian());
 }
 
-template <typename T>
-int VectorStats<T>::getLeftSkew(int8_t deviations) const {
+// 1.4826 scales the MAD to the standard deviation of normally distributed data.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR int VectorStats<T, N, Policy>::getHampelOutliers(float threshold) {
+    double median = _scratchMedian();
+    double limit = threshold * 1.4826 * _deviationMedian(median);
+    return VectorStatsKernels<T>::countOutside(_data_array.data(), _size, median - limit, median + limit);
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::Result VectorStats<T, N, Policy>::getTrimmedMean(float proportion) {
+    int cut = _trimSelect(proportion);
+    return (double)Policy::sum(_extensions->scratch.data() + cut, _size - 2 * cut) / (_size - 2 * cut);
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::Result VectorStats<T, N, Policy>::getWinsorizedMean(float proportion) {
+    int cut = _trimSelect(proportion);
+    const std::vector<T>& scratch = _extensions->scratch;
+    double sum = Policy::sum(scratch.data() + cut, _size - 2 * cut);
+    sum += (double)cut * scratch[cut] + (double)cut * scratch[_size - cut - 1];
+    return sum / _size;
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR int VectorStats<T, N, Policy>::getLeftSkew(int8_t deviations) const {
     if (!_data_ordered) {
         return -1;
     }
 
-    float sum = std::accumulate(_data_array.begin() + _mid_element, _data_array.end(), 0.0);
-    float mean = sum / (_size - _mid_element);
-    float variance = std::inner_product(_data_array.begin() + _mid_element, _data_array.end(), _data_array.begin() + 
-        _mid_element, 0.0, std::plus<float>(), [mean](float x, float y) { return (x - mean) * (y - mean); }) / (_size - _mid_element);
+    // The right half holds the newest elements. It wraps past the end of the array when _element is past the middle.
+    const T* data = _data_array.data();
+    int right_size = _size - _mid_element;
+    int right_start = (_element + _mid_element) % _size;
+    int first = right_size < _size - right_start ? right_size : _size - right_start;
+    Accumulator right_sum = Policy::sum(data + right_start, first);
+    right_sum += Policy::sum(data, right_size - first);
+    float mean = (double)right_sum / right_size;
+    float variance = (VectorStatsKernels<T>::sumSquaredDeviations(data + right_start, first, mean) +
+                      VectorStatsKernels<T>::sumSquaredDeviations(data, right_size - first, mean)) / right_size;
     float stdDev = std::sqrt(variance);
 
     // int skew_count = 0;
@@ -354,12 +1108,278 @@ int VectorStats<T>::getLeftSkew(int8_t deviations) const {
     // }
     // return skew_count;
 
+    return _leftSkewCount(mean, stdDev, deviations);
+}
+
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::Result VectorStats<T, N, Policy>::getSlope() const {
+    Probe probe(*this, VectorStatsMethod::getSlope);
+    if (!_data_ordered) {
+        return -1;
+    }
+    
+    // Sum of (x - x_avg)(y - y_avg) reduces to sum(x y) - x_avg sum(y).
+    // Sum of (x - x_avg)^2 over x = 1..n is n(n^2 - 1) / 12.
+    // The shift of the incremental sums cancels out of the numerator.
+    double x_avg = (1 + _size) / 2.0;
+    double denominator = (double)_size * ((double)_size * _size - 1) / 12.0;
+    if (_incremental_moments) {
+        return ((double)_extensions->moment_weighted - x_avg * (double)_extensions->moment_sum) / denominator;
+    }
+    Instrumentation::touched(VectorStatsMethod::getSlope, _size);
+    double total = 0.0, weighted = 0.0;
+    _chronologicalSums(total, weighted);
+    return (weighted - x_avg * total) / denominator;
+}
+
+// Walks the buffer in tiles so every tile is loaded from memory once and reused by each kernel.
+// Squares are taken around the first element so both halves share one center.
+// Halves follow insertion order, so tiles are also cut where the newest half starts.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR VectorStatsSummary<T, typename Policy::result_type> VectorStats<T, N, Policy>::getSummary(int8_t deviations) const {
+    Probe probe(*this, VectorStatsMethod::getSummary);
+    Instrumentation::touched(VectorStatsMethod::getSummary, 2 * _size);
+    typedef VectorStatsKernels<T> Kernels;
+    const int tile = sizeof(T) < 8 ? 8192 / sizeof(T) : 1024;
+    const T* data = _data_array.data();
+    const double center = data[0];
+    double sums[2] = {0.0, 0.0};
+    double squares[2] = {0.0, 0.0};
+    double weighted = 0.0;
+    T low = data[0], high = data[0];
+
+    double newest_sum = 0.0;  // Sum of elements before _element, which were added after the oldest one.
+
+    const int split = (_element + _mid_element) % _size;  // Slot of the first element of the newest half.
+    for (int start = 0, end = 0; start < _size; start = end) {
+        end = _size - start < tile ? _size : start + tile;
+        if (start < _element && _element < end) {
+            end = _element;
+        }
+        if (start < split && split < end) {
+            end = split;
+        }
+        int half = (start - _element + _size) % _size >= _mid_element;
+        int count = end - start;
+        double tile_sum = 0.0, tile_squares = 0.0;
+        T tile_low = data[start], tile_high = data[start];
+        Kernels::moments(data + start, count, center, tile_sum, tile_squares);
+        Kernels::minMax(data + start, count, tile_low, tile_high);
+        sums[half] += tile_sum;
+        squares[half] += tile_squares;
+        weighted += Kernels::weightedSum(data + start, count) + (double)start * tile_sum;
+        if (start < _element) newest_sum += tile_sum;
+        if (tile_low < low) low = tile_low;
+        if (high < tile_high) high = tile_high;
+    }
+
+    VectorStatsSummary<T, Result> summary = VectorStatsSummary<T, Result>();
+    double total = sums[0] + sums[1];
+    double mean = total / _size;
+    double variance = (squares[0] + squares[1]) / _size - (mean - center) * (mean - center);
+    summary.mean = mean;
+    summary.std_dev = variance > 0 ? std::sqrt(variance) : 0;
+    summary.min = low;
+    summary.max = high;
+
+    float limit = summary.std_dev * deviations;
+    summary.outliers = Kernels::countOutside(data, _size, summary.mean - limit, summary.mean + limit);
+
+    if (!_data_ordered) {
+        summary.slope = -1;
+        summary.left_skew = -1;
+        return summary;
+    }
+
+    // Index order weights become insertion order weights with x = 1 at _element.
+    weighted += (double)_size * newest_sum - (double)_element * total;
+    double x_avg = (1 + _size) / 2.0;
+    double denominator = (double)_size * ((double)_size * _size - 1) / 12.0;
+    summary.slope = (weighted - x_avg * total) / denominator;
+
+    int right_size = _size - _mid_element;
+    double right_mean = sums[1] / right_size;
+    double right_variance = squares[1] / right_size - (right_mean - center) * (right_mean - center);
+    summary.left_skew = _leftSkewCount(right_mean, right_variance > 0 ? std::sqrt(right_variance) : 0, deviations);
+    return summary;
+}
+
+// Small buffers are faster on the calling thread than the cost of waking the pool.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR bool VectorStats<T, N, Policy>::_useParallel() const {
+#if defined(VECTORSTATS_PARALLEL)
+    return _parallel && _size >= _parallel->threshold();
+#else
+    return false;
+#endif
+}
+
+// Median of a fresh scratch copy. Even sizes are averaged without rounding.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR double VectorStats<T, N, Policy>::_scratchMedian() {
+    std::vector<T>& scratch = _extensions.get().scratch;
+    scratch.assign(_data_array.begin(), _data_array.end());
+    std::nth_element(scratch.begin(), scratch.begin() + _mid_element, scratch.end());
+    double right_mid = scratch[_mid_element];
+    if (_odd_parity) {
+        return right_mid;
+    }
+    double left_mid = *std::max_element(scratch.begin(), scratch.begin() + _mid_element);
+    return (left_mid + right_mid) / 2;
+}
+
+// Median of |value - center| using the same selection as _scratchMedian().
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR double VectorStats<T, N, Policy>::_deviationMedian(double center) {
+    std::vector<Result>& deviations = _extensions.get().deviations;
+    deviations.resize(_size);
+    for (int i = 0; i < _size; ++i) {
+        deviations[i] = std::fabs((double)_data_array[i] - center);
+    }
+    std::nth_element(deviations.begin(), deviations.begin() + _mid_element, deviations.end());
+    double right_mid = deviations[_mid_element];
+    if (_odd_parity) {
+        return right_mid;
+    }
+    double left_mid = *std::max_element(deviations.begin(), deviations.begin() + _mid_element);
+    return (left_mid + right_mid) / 2;
+}
+
+// Copies the buffer and partitions it so [cut, size - cut) holds the kept values.
+// Returns cut, the number of values beyond each end.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR int VectorStats<T, N, Policy>::_trimSelect(float proportion) {
+    int cut = proportion > 0 ? (int)(proportion * _size) : 0;
+    if (2 * cut >= _size) {
+        cut = (_size - 1) / 2;
+    }
+    std::vector<T>& scratch = _extensions.get().scratch;
+    scratch.assign(_data_array.begin(), _data_array.end());
+    if (cut > 0) {
+        // Upper bound first so the second selection leaves it in place. Both bounds end up at their ranks.
+        std::nth_element(scratch.begin(), scratch.end() - cut - 1, scratch.end());
+        std::nth_element(scratch.begin(), scratch.begin() + cut, scratch.end() - cut - 1);
+    }
+    return cut;
+}
+
+// Average of the center two numbers for even-sized buffers.
+// Integer types truncate, floating point types are not rounded.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR T VectorStats<T, N, Policy>::_midpoint(T left_mid, T right_mid) const {
+    return (left_mid + right_mid) / 2;
+}
+
+// Copies one contiguous run into the buffer.
+// Slot trackers are updated per value, the moments once for the whole run.
+// weighted_delta gathers sum(j * (new - old)) + n * sum(new) over batch positions j for addBatch().
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::_writeSegment(int start, const T* values, int count,
+                                                            int batch_offset, MomentSum& weighted_delta) {
+    T* segment = _data_array.data() + start;
+    if (_rolling_median || _rolling_extrema || _histogram || _sorted_shadow) {
+        for (int i = 0; i < count; ++i) {
+            if (_rolling_median) {
+                _extensions->median_heap.replace(start + i, values[i]);
+            }
+            if (_rolling_extrema) {
+                _extensions->extrema.replace(start + i, values[i]);
+            }
+            if (_histogram) {
+                _extensions->histogram_bins.replace(segment[i], values[i]);
+            }
+            if (_sorted_shadow) {
+                _extensions->shadow.replace(segment[i], values[i]);
+            }
+        }
+    }
+
+    double old_sum = 0.0, old_squares = 0.0;
+    MomentSum old_weighted = 0;
+    if (_incremental_moments) {
+        VectorStatsKernels<T>::moments(segment, count, _extensions->moment_shift, old_sum, old_squares);
+        old_weighted = _shiftedWeightedSum(segment, count);
+    }
+    std::copy(values, values + count, segment);
+    if (_incremental_moments) {
+        double new_sum = 0.0, new_squares = 0.0;
+        VectorStatsKernels<T>::moments(segment, count, _extensions->moment_shift, new_sum, new_squares);
+        MomentSum new_weighted = _shiftedWeightedSum(segment, count);
+
+        // Kernel sums are not shifted.
+        MomentSum shift_total = (MomentSum)_extensions->moment_shift * count;
+        MomentSum new_shifted = (MomentSum)new_sum - shift_total;
+        MomentSum old_shifted = (MomentSum)old_sum - shift_total;
+        weighted_delta += (MomentSum)batch_offset * (new_shifted - old_shifted) +
+                          (new_weighted - new_shifted) - (old_weighted - old_shifted) + (MomentSum)_size * new_shifted;
+        _extensions->moment_sum += new_shifted - old_shifted;
+        _extensions->moment_sum_sq += (MomentSum)new_squares - (MomentSum)old_squares;
+    }
+}
+
+// Sum of (i + 1) * (data[i] - moment_shift). Exact for small integer types.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR typename VectorStats<T, N, Policy>::MomentSum VectorStats<T, N, Policy>::_shiftedWeightedSum(const T* data, int count) const {
+    MomentSum weighted = 0;
+    for (int i = 0; i < count; ++i) {
+        weighted += (MomentSum)(i + 1) * ((MomentSum)data[i] - (MomentSum)_extensions->moment_shift);
+    }
+    return weighted;
+}
+
+// Sum and sum of x * value with x = 1 at the oldest element, _element.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::_chronologicalSums(double& total, double& weighted) const {
+    const T* data = _data_array.data();
+    int oldest_count = _size - _element;
+    double oldest_sum, newest_sum, oldest_weighted, newest_weighted;
+#if defined(VECTORSTATS_PARALLEL)
+    if (_useParallel()) {
+        oldest_sum = _parallel->sum(data + _element, oldest_count);
+        newest_sum = _element ? _parallel->sum(data, _element) : 0;
+        oldest_weighted = _parallel->weightedSum(data + _element, oldest_count);
+        newest_weighted = _element ? _parallel->weightedSum(data, _element) : 0;
+        total = oldest_sum + newest_sum;
+        weighted = oldest_weighted + newest_weighted + (double)oldest_count * newest_sum;
+        return;
+    }
+#endif
+    oldest_sum = VectorStatsKernels<T>::sum(data + _element, oldest_count);
+    newest_sum = VectorStatsKernels<T>::sum(data, _element);
+    oldest_weighted = VectorStatsKernels<T>::weightedSum(data + _element, oldest_count);
+    newest_weighted = VectorStatsKernels<T>::weightedSum(data, _element);
+    total = oldest_sum + newest_sum;
+    weighted = oldest_weighted + newest_weighted + (double)oldest_count * newest_sum;
+}
+
+// Places every rank in sorted ranks[] at its sorted position within [first, last).
+// Selecting the middle rank splits the remaining ranks between two smaller ranges.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::_multiSelect(int first, int last, const int* ranks, int rank_count) {
+    if (rank_count == 0 || last - first < 2) {
+        return;
+    }
+    int mid = rank_count / 2;
+    auto begin = _data_array.begin();
+    std::nth_element(begin + first, begin + ranks[mid], begin + last);
+    _multiSelect(first, ranks[mid], ranks, mid);
+    _multiSelect(ranks[mid] + 1, last, ranks + mid + 1, rank_count - mid - 1);
+}
+
+// Counts leading elements outside of mean +/- (deviations * stdDev), oldest first.
+// Negative when the leading outliers sit below the mean.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR int VectorStats<T, N, Policy>::_leftSkewCount(float mean, float stdDev, int8_t deviations) const {
+    const T* data = _data_array.data();
     int skew_count = 0;
-    for (T value : _data_array) {
-        if (std::abs(value - mean) > (stdDev * deviations)) {
+    for (int i = 0, index = _element; i < _size; ++i, index = index + 1 < _size ? index + 1 : 0) {
+        if (std::abs(data[index] - mean) > (stdDev * deviations)) {
             skew_count++;
         } else if (skew_count > 0) {
-            float skew_sum = std::accumulate(_data_array.begin(), _data_array.begin() + skew_count, 0.0);
+            int first = skew_count < _size - _element ? skew_count : _size - _element;
+            Accumulator skew_total = Policy::sum(data + _element, first);
+            skew_total += Policy::sum(data, skew_count - first);
+            float skew_sum = skew_total;
             float skew_mean = skew_sum / skew_count;
             if (skew_mean < mean) {
                 skew_count *= -1;
@@ -370,22 +1390,67 @@ int VectorStats<T>::getLeftSkew(int8_t deviations) const {
     return skew_count;
 }
 
-template <typename T>
-float VectorStats<T>::getSlope() const {
-    if (!_data_ordered) {
-        return -1;
+// Trackers index buffer slots so they must be rebuilt whenever the buffer is rewritten wholesale.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::_rebuildTrackers() {
+    if (_rolling_median) {
+        _extensions->median_heap.build(_data_array.data(), _size);
     }
-    
-    float x_avg = (1 + _size) / 2;
-    float y_avg = getAverage();
-    float numerator = 0.0;
-    float denominator = 0.0;    
+    if (_rolling_extrema) {
+        _extensions->extrema.build(_data_array.data(), _size, _element);
+    }
+    if (_histogram) {
+        _extensions->histogram_bins.build(_data_array.data(), _size, _extensions->histogram_min, _extensions->histogram_max);
+    }
+    if (_sorted_shadow) {
+        _extensions->shadow.build(_data_array.data(), _size);
+    }
+    if (_incremental_moments) {
+        _rebuildMoments();
+    }
+}
 
-    for (int i = 0; i < _size; ++i) {
-        numerator += (i + 1 - x_avg) * (_data_array[i] - y_avg);
-        denominator += std::pow(i + 1 - x_avg, 2);
+// Re-centers the shift on the current mean and re-sums the buffer.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::_rebuildMoments() {
+    Extensions& moments = _extensions.get();
+    double mean = VectorStatsKernels<T>::sum(_data_array.data(), _size) / _size;
+    moments.moment_shift = std::is_integral<T>::value ? (T)std::round(mean) : (T)mean;
+    moments.moment_sum = 0;
+    moments.moment_sum_sq = 0;
+    moments.moment_weighted = 0;
+    int index = _element;
+    for (int x = 1; x <= _size; ++x) {
+        MomentSum shifted = (MomentSum)_data_array[index] - (MomentSum)moments.moment_shift;
+        moments.moment_sum += shifted;
+        moments.moment_sum_sq += shifted * shifted;
+        moments.moment_weighted += (MomentSum)x * shifted;
+        if (++index == _size) index = 0;
     }
-    return numerator / denominator;
+    moments.moment_updates = 0;
+}
+
+// Swaps the evicted value for the new one. Inexact sums re-normalize once per buffer length.
+// Every other value moves one x position older, so W = W - S + n * new.
+template <typename T, int N, typename Policy>
+VECTORSTATS_CONSTEXPR void VectorStats<T, N, Policy>::_updateMoments(T old_value, T new_value) {
+    Extensions& moments = *_extensions;
+    MomentSum shifted_old = (MomentSum)old_value - (MomentSum)moments.moment_shift;
+    MomentSum shifted_new = (MomentSum)new_value - (MomentSum)moments.moment_shift;
+    moments.moment_weighted += (MomentSum)_size * shifted_new - moments.moment_sum;
+    moments.moment_sum += shifted_new - shifted_old;
+    moments.moment_sum_sq += shifted_new * shifted_new - shifted_old * shifted_old;
+
+    if (!std::is_integral<MomentSum>::value && ++moments.moment_updates >= _size) {
+        _rebuildMoments();
+    }
+}
+
+// Returned by getQuantileSketch() while no sketch was ever enabled.
+template <typename T, int N, typename Policy>
+const VectorStatsQuantileSketch<T>& VectorStats<T, N, Policy>::_emptySketch() {
+    static const VectorStatsQuantileSketch<T> empty;
+    return empty;
 }
 
 
@@ -0,0 +1,301 @@
+/**
+ * @file VectorStatsBank.h
+ * @brief This header file contains declarations for the VectorStatsBank class.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_BANK_H
+#define VECTORSTATS_BANK_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @class VectorStatsBank
+ * @brief Buffers many channels in one allocation for multi-sensor data collection.
+ * - Every add() stores one interleaved frame holding one sample per channel.
+ * - Frames are stored contiguously so the reductions run across channels in SIMD lanes.
+ * - Average, standard deviation, min and max are calculated for all channels at once.
+ * - Median is calculated per channel on a scratch copy and does not change the buffer.
+ * @tparam T The data type of the buffer elements.
+ * @tparam Channels The number of channels in every frame.
+ */
+template <typename T, int Channels>
+class VectorStatsBank {
+    static_assert(Channels > 0, "VectorStatsBank needs at least one channel.");
+
+public:
+    /**
+     * @brief Constructor for VectorStatsBank.
+     * @param max_buffer_size An integer value to initialize the maximum number of frames.
+     */
+    VectorStatsBank(int max_buffer_size);
+
+    /**
+     * @brief Returns current number of frames in the buffer.
+     */
+    int size() const;
+
+    /**
+     * @brief Returns the number of channels in every frame.
+     */
+    int channels() const;
+
+    /**
+     * @brief Resizes and zeroes buffer.
+     * @param buffer_size An integer value for new number of frames.
+     * - Entering a buffer size greater than max_buffer_size will have no effect.
+     */
+    void resize(int buffer_size);
+
+    /**
+     * @brief Zeroes the buffer and sets .bufferFull() to false.
+     */
+    void zeroBuffer();
+
+    /**
+     * @brief Adds one frame replacing the oldest frame.
+     * @param frame Pointer to Channels interleaved values, one per channel.
+     */
+    void add(const T* frame);
+
+    /**
+     * @brief Fills every frame with the same frame.
+     * @param frame Pointer to Channels interleaved values, one per channel.
+     * Sets .bufferFull() to true.
+     */
+    void fillBuffer(const T* frame);
+
+    /**
+     * @brief Checks state of buffer.
+     * @return Boolean true if the last add() filled the last frame.
+     */
+    bool bufferFull() const;
+
+    /**
+     * @brief Gets one element of one channel.
+     * @return Element as <initalized data type>. Returns -1 if out of range.
+     */
+    T getElement(int channel, int element) const;
+
+    /**
+     * @brief Calculates the average of every channel.
+     * @param averages Array of Channels floats to receive the averages.
+     */
+    void getAverages(float* averages) const;
+
+    /**
+     * @brief Calculates the population standard deviation of every channel.
+     * @param std_devs Array of Channels floats to receive the standard deviations.
+     */
+    void getStdDevs(float* std_devs) const;
+
+    /**
+     * @brief Finds the smallest and largest value of every channel.
+     * @param mins Array of Channels values to receive the minimums.
+     * @param maxes Array of Channels values to receive the maximums.
+     */
+    void getMinMax(T* mins, T* maxes) const;
+
+    /**
+     * @brief Calculates median of one channel.
+     * - Copies the channel into scratch memory. The buffer order is not changed.
+     * @param channel Channel index from 0 to Channels - 1.
+     * @return Median as <initalized data type>. Returns -1 if channel is out of range.
+     * - Returns rounded average of center two numbers for even-sized buffers.
+     */
+    T getMedian(int channel);
+
+private:
+    // 16 bit and smaller integers sum exactly in 32 bit lanes that are flushed before they can overflow.
+    static const bool _small_int = std::is_integral<T>::value && sizeof(T) <= 2;
+    typedef typename std::conditional<_small_int, int32_t, double>::type LaneSum;
+    typedef typename std::conditional<_small_int, int64_t, double>::type TotalSum;
+    static const int _flush_frames = 32768;
+
+    std::vector<T> _frames;  // Frame-major: element e of channel c is _frames[e * Channels + c].
+    std::vector<T> _scratch;
+    const int _max_buffer_size;
+    int _size;
+    int _element;
+    bool _buffer_full;
+
+    void _sums(TotalSum* totals) const;
+};
+
+
+////////////////////////////////////////
+// VectorStatsBank Class Implementation
+////////////////////////////////////////
+
+template <typename T, int Channels>
+VectorStatsBank<T, Channels>::VectorStatsBank(int max_buffer_size)
+    : _frames((size_t)max_buffer_size * Channels),  // Preallocates memory.
+      _max_buffer_size(max_buffer_size),
+      _size(max_buffer_size),
+      _element(0),
+      _buffer_full(false) {}
+
+template <typename T, int Channels>
+int VectorStatsBank<T, Channels>::size() const {
+    return _size;
+}
+
+template <typename T, int Channels>
+int VectorStatsBank<T, Channels>::channels() const {
+    return Channels;
+}
+
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::resize(int buffer_size) {
+    if (buffer_size <= _max_buffer_size) {
+        _size = buffer_size;
+        _frames.resize((size_t)buffer_size * Channels);
+        zeroBuffer();
+    }
+}
+
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::zeroBuffer() {
+    std::fill(_frames.begin(), _frames.end(), 0);
+    _element = 0;
+    _buffer_full = false;
+}
+
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::add(const T* frame) {
+    std::copy(frame, frame + Channels, _frames.begin() + (size_t)_element * Channels);
+    if (_element < _size - 1) {
+        _element++;
+        _buffer_full = false;
+    } else {
+        _element = 0;
+        _buffer_full = true;
+    }
+}
+
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::fillBuffer(const T* frame) {
+    for (int e = 0; e < _size; ++e) {
+        std::copy(frame, frame + Channels, _frames.begin() + (size_t)e * Channels);
+    }
+    _buffer_full = true;
+}
+
+template <typename T, int Channels>
+bool VectorStatsBank<T, Channels>::bufferFull() const {
+    return _buffer_full;
+}
+
+template <typename T, int Channels>
+T VectorStatsBank<T, Channels>::getElement(int channel, int element) const {
+    if (channel >= 0 && channel < Channels && element >= 0 && element < _size) {
+        return _frames[(size_t)element * Channels + channel];
+    } else { return -1; }
+}
+
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::getAverages(float* averages) const {
+    TotalSum totals[Channels];
+    _sums(totals);
+    for (int c = 0; c < Channels; ++c) {
+        averages[c] = (double)totals[c] / _size;
+    }
+}
+
+// Two passes like VectorStats::getStdDev(). The inner loops run across channels.
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::getStdDevs(float* std_devs) const {
+    TotalSum totals[Channels];
+    _sums(totals);
+    double means[Channels];
+    double squares[Channels];
+    for (int c = 0; c < Channels; ++c) {
+        means[c] = (double)totals[c] / _size;
+        squares[c] = 0.0;
+    }
+
+    const T* frame = _frames.data();
+    for (int e = 0; e < _size; ++e, frame += Channels) {
+        for (int c = 0; c < Channels; ++c) {
+            double deviation = frame[c] - means[c];
+            squares[c] += deviation * deviation;
+        }
+    }
+    for (int c = 0; c < Channels; ++c) {
+        std_devs[c] = std::sqrt(squares[c] / _size);
+    }
+}
+
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::getMinMax(T* mins, T* maxes) const {
+    T low[Channels], high[Channels];
+    const T* frame = _frames.data();
+    for (int c = 0; c < Channels; ++c) {
+        low[c] = frame[c];
+        high[c] = frame[c];
+    }
+    for (int e = 1; e < _size; ++e) {
+        frame += Channels;
+        for (int c = 0; c < Channels; ++c) {
+            low[c] = frame[c] < low[c] ? frame[c] : low[c];
+            high[c] = high[c] < frame[c] ? frame[c] : high[c];
+        }
+    }
+    std::copy(low, low + Channels, mins);
+    std::copy(high, high + Channels, maxes);
+}
+
+// Uses the nth_element algorithm on a copy of the channel.
+template <typename T, int Channels>
+T VectorStatsBank<T, Channels>::getMedian(int channel) {
+    if (channel < 0 || channel >= Channels) {
+        return -1;
+    }
+
+    _scratch.resize(_size);
+    for (int e = 0; e < _size; ++e) {
+        _scratch[e] = _frames[(size_t)e * Channels + channel];
+    }
+
+    int mid_element = _size / 2;
+    std::nth_element(_scratch.begin(), _scratch.begin() + mid_element, _scratch.end());
+    T right_mid = _scratch[mid_element];
+    if (_size % 2) {
+        return right_mid;
+    }
+    T left_mid = *std::max_element(_scratch.begin(), _scratch.begin() + mid_element);
+    return (left_mid + right_mid) / 2;
+}
+
+// Sums every channel in lanes, flushing 32 bit lanes into 64 bit totals.
+template <typename T, int Channels>
+void VectorStatsBank<T, Channels>::_sums(TotalSum* totals) const {
+    for (int c = 0; c < Channels; ++c) {
+        totals[c] = 0;
+    }
+
+    const T* frame = _frames.data();
+    for (int start = 0; start < _size; start += _flush_frames) {
+        int end = std::min(_size, start + _flush_frames);
+        LaneSum lanes[Channels];
+        for (int c = 0; c < Channels; ++c) {
+            lanes[c] = 0;
+        }
+        for (int e = start; e < end; ++e, frame += Channels) {
+            for (int c = 0; c < Channels; ++c) {
+                lanes[c] += frame[c];
+            }
+        }
+        for (int c = 0; c < Channels; ++c) {
+            totals[c] += lanes[c];
+        }
+    }
+}
+
+
+#endif
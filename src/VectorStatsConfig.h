@@ -0,0 +1,47 @@
+/**
+ * @file VectorStatsConfig.h
+ * @brief This header file contains compiler feature switches shared by the VectorStats headers.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_CONFIG_H
+#define VECTORSTATS_CONFIG_H
+
+// C++20 made std::vector, std::sort and std::nth_element usable in constant expressions.
+// Older standards still compile everything, just not at compile time.
+#if __cplusplus >= 202002L
+#define VECTORSTATS_CONSTEXPR constexpr
+#else
+#define VECTORSTATS_CONSTEXPR
+#endif
+
+// std::is_constant_evaluated() lets constexpr code step around SIMD intrinsics.
+#if __cplusplus >= 202002L
+#include <type_traits>
+#define VECTORSTATS_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define VECTORSTATS_IS_CONSTANT_EVALUATED() false
+#endif
+
+// std::span overloads are offered when the standard library has them.
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define VECTORSTATS_HAS_SPAN 1
+#endif
+#endif
+
+// SIMD reduction kernels are picked at compile time from the target flags.
+// Define VECTORSTATS_NO_SIMD to force the portable scalar kernels.
+#if defined(VECTORSTATS_NO_SIMD)
+#elif defined(__AVX2__)
+#define VECTORSTATS_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VECTORSTATS_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VECTORSTATS_SIMD_NEON 1
+#endif
+
+
+#endif
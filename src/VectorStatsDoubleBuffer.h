@@ -0,0 +1,116 @@
+/**
+ * @file VectorStatsDoubleBuffer.h
+ * @brief This header file contains declarations for the VectorStatsDoubleBuffer class.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_DOUBLE_BUFFER_H
+#define VECTORSTATS_DOUBLE_BUFFER_H
+
+#include "VectorStats.h"
+
+/**
+ * @class VectorStatsDoubleBuffer
+ * @brief Ping-pong pair of VectorStats buffers so acquisition never waits for getMedian().
+ * - add() fills one buffer. When it fills the last element the buffers swap roles in O(1).
+ * - The completed window becomes the snapshot. getMedian(), getSortedElement() and every
+ *   other statistic run on the snapshot while add() keeps filling the other buffer.
+ * - A snapshot stays valid until the next window completes, then its buffer is reused.
+ * @tparam T The data type of the vector and buffer elements.
+ * @tparam N Fixed buffer size. Default = 0 for a runtime sized buffer.
+ * @tparam Policy Accumulator and result types of both buffers. Default = VectorStatsPolicy<>.
+ */
+template <typename T, int N = 0, typename Policy = VectorStatsPolicy<>>
+class VectorStatsDoubleBuffer {
+public:
+    /**
+     * @brief Constructor for VectorStatsDoubleBuffer.
+     * @param buffer_size Window size of both buffers.
+     * - Only for runtime sized buffers (N = 0).
+     */
+    VectorStatsDoubleBuffer(int buffer_size);
+
+    /**
+     * @brief Constructor for fixed-size VectorStatsDoubleBuffer<T, N>.
+     * - Only for fixed size buffers (N > 0).
+     */
+    VectorStatsDoubleBuffer();
+
+    /**
+     * @brief Adds a value to the filling buffer. Swaps buffers when the window completes.
+     */
+    void add(T value);
+
+    /**
+     * @brief Checks for a completed window that has not been read with snapshot() yet.
+     * @return Boolean true after a swap, false again once snapshot() is called.
+     */
+    bool snapshotReady() const;
+
+    /**
+     * @brief Gets the most recently completed window.
+     * - Safe to reorder with getMedian() or getSortedElement().
+     * - Holds zeros until the first window completes.
+     * @return Reference to the VectorStats buffer holding the snapshot.
+     */
+    VectorStats<T, N, Policy>& snapshot();
+
+    /**
+     * @brief Gets the buffer that add() is currently filling.
+     * @return Const reference so the filling buffer cannot be reordered.
+     */
+    const VectorStats<T, N, Policy>& filling() const;
+
+private:
+    VectorStats<T, N, Policy> _buffers[2];
+    int _filling;
+    bool _snapshot_ready;
+};
+
+
+////////////////////////////////////////
+// VectorStatsDoubleBuffer Implementation
+////////////////////////////////////////
+
+template <typename T, int N, typename Policy>
+VectorStatsDoubleBuffer<T, N, Policy>::VectorStatsDoubleBuffer(int buffer_size)
+    : _buffers{VectorStats<T, N, Policy>(buffer_size), VectorStats<T, N, Policy>(buffer_size)},
+      _filling(0),
+      _snapshot_ready(false) {}
+
+template <typename T, int N, typename Policy>
+VectorStatsDoubleBuffer<T, N, Policy>::VectorStatsDoubleBuffer()
+    : _buffers{},
+      _filling(0),
+      _snapshot_ready(false) {}
+
+// The filling buffer wraps to element 0 when it completes, so the reused buffer needs no reset.
+template <typename T, int N, typename Policy>
+void VectorStatsDoubleBuffer<T, N, Policy>::add(T value) {
+    VectorStats<T, N, Policy>& buffer = _buffers[_filling];
+    buffer.add(value);
+    if (buffer.bufferFull()) {
+        _filling ^= 1;
+        _snapshot_ready = true;
+    }
+}
+
+template <typename T, int N, typename Policy>
+bool VectorStatsDoubleBuffer<T, N, Policy>::snapshotReady() const {
+    return _snapshot_ready;
+}
+
+template <typename T, int N, typename Policy>
+VectorStats<T, N, Policy>& VectorStatsDoubleBuffer<T, N, Policy>::snapshot() {
+    _snapshot_ready = false;
+    return _buffers[_filling ^ 1];
+}
+
+template <typename T, int N, typename Policy>
+const VectorStats<T, N, Policy>& VectorStatsDoubleBuffer<T, N, Policy>::filling() const {
+    return _buffers[_filling];
+}
+
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file VectorStatsExtrema.h
+ * @brief This header file contains the monotonic deques used by VectorStats for sliding min and max.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_EXTREMA_H
+#define VECTORSTATS_EXTREMA_H
+
+#include <vector>
+#include "VectorStatsConfig.h"
+
+/**
+ * @class VectorStatsExtrema
+ * @brief Sliding window min and max over a circular buffer.
+ * - The min deque keeps buffer slots with increasing values, oldest first.
+ * - The max deque keeps buffer slots with decreasing values, oldest first.
+ * - A new value drops every newer slot it beats from the back, so each slot is pushed and popped once.
+ * - The slot being overwritten is always the oldest, so it can only ever be at the front.
+ * - replace() is amortized O(1). min() and max() are O(1).
+ * @tparam T The data type of the buffer elements.
+ */
+template <typename T>
+class VectorStatsExtrema {
+public:
+    /**
+     * @brief Rebuilds both deques from a buffer.
+     * @param data Pointer to the first buffer element.
+     * @param size Number of elements in the buffer.
+     * @param oldest Index of the oldest element. Later elements follow it around the buffer.
+     */
+    VECTORSTATS_CONSTEXPR void build(const T* data, int size, int oldest);
+
+    /**
+     * @brief Replaces the oldest slot with a new value.
+     * @param slot Buffer index being overwritten. Must be the oldest slot.
+     * @param value New value of the slot.
+     */
+    VECTORSTATS_CONSTEXPR void replace(int slot, T value);
+
+    /**
+     * @brief Releases all memory held by the deques.
+     */
+    VECTORSTATS_CONSTEXPR void clear();
+
+    /**
+     * @brief Gets the smallest value in the buffer.
+     */
+    VECTORSTATS_CONSTEXPR T min() const;
+
+    /**
+     * @brief Gets the largest value in the buffer.
+     */
+    VECTORSTATS_CONSTEXPR T max() const;
+
+private:
+    struct Node {
+        T value;
+        int slot;
+    };
+
+    // Fixed capacity ring so the deques never allocate after build().
+    struct Ring {
+        std::vector<Node> nodes;
+        int head = 0;
+        int count = 0;
+
+        VECTORSTATS_CONSTEXPR const Node& front() const { return nodes[head]; }
+        VECTORSTATS_CONSTEXPR const Node& back() const { return nodes[_wrap(head + count - 1)]; }
+        VECTORSTATS_CONSTEXPR void popFront() { head = _wrap(head + 1); count--; }
+        VECTORSTATS_CONSTEXPR void popBack() { count--; }
+        VECTORSTATS_CONSTEXPR void pushBack(const Node& node) { nodes[_wrap(head + count)] = node; count++; }
+        VECTORSTATS_CONSTEXPR int _wrap(int index) const { return index >= (int)nodes.size() ? index - (int)nodes.size() : index; }
+    };
+
+    Ring _low;   // Increasing values. Front is the min.
+    Ring _high;  // Decreasing values. Front is the max.
+
+    VECTORSTATS_CONSTEXPR void _push(int slot, T value);
+};
+
+
+////////////////////////////////////////
+// VectorStatsExtrema Implementation
+////////////////////////////////////////
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsExtrema<T>::build(const T* data, int size, int oldest) {
+    _low.nodes.resize(size);
+    _high.nodes.resize(size);
+    _low.head = _low.count = 0;
+    _high.head = _high.count = 0;
+    int slot = oldest;
+    for (int i = 0; i < size; ++i) {
+        _push(slot, data[slot]);
+        if (++slot == size) slot = 0;
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsExtrema<T>::replace(int slot, T value) {
+    if (_low.count && _low.front().slot == slot) _low.popFront();
+    if (_high.count && _high.front().slot == slot) _high.popFront();
+    _push(slot, value);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsExtrema<T>::clear() {
+    std::vector<Node>().swap(_low.nodes);
+    std::vector<Node>().swap(_high.nodes);
+    _low.head = _low.count = 0;
+    _high.head = _high.count = 0;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsExtrema<T>::min() const {
+    return _low.front().value;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsExtrema<T>::max() const {
+    return _high.front().value;
+}
+
+// Older slots that are no better than the new value can never be the answer again.
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsExtrema<T>::_push(int slot, T value) {
+    while (_low.count && !(_low.back().value < value)) _low.popBack();
+    while (_high.count && !(value < _high.back().value)) _high.popBack();
+    _low.pushBack(Node{value, slot});
+    _high.pushBack(Node{value, slot});
+}
+
+
+#endif
@@ -0,0 +1,383 @@
+/**
+ * @file VectorStatsFilters.h
+ * @brief This header file contains sliding window filters for whole arrays of logged data.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_FILTERS_H
+#define VECTORSTATS_FILTERS_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include "VectorStatsConfig.h"
+#include "VectorStatsMedianHeap.h"
+
+/**
+ * @class VectorStatsFilters
+ * @brief Sliding window filters that process a whole array in one call.
+ * - out[i] is the statistic of the window of values ending at in[i], like calling add(in[i]) on a
+ *   VectorStats buffer of window size that was filled with in[0] and then reading the statistic.
+ * - Each window is updated from the previous one instead of being recalculated.
+ * - in and out may be the same array.
+ * @tparam T The data type of the input values.
+ */
+template <typename T>
+class VectorStatsFilters {
+public:
+    /**
+     * @brief Sliding median of every window.
+     * - Uses the same indexed two-heap as setRollingMedian(). O(log window) per value.
+     * - Even windows average the center two values like getMedian().
+     * @param in Input values.
+     * @param out Receives size filtered values.
+     * @param size Number of values.
+     * @param window Number of values in each window.
+     */
+    static void medianFilter(const T* in, T* out, int size, int window);
+
+    /**
+     * @brief Sliding average of every window.
+     * - Keeps a running sum. O(1) per value.
+     * - 8 and 16 bit integers are summed exactly. Other types re-sum the window every window values so rounding cannot drift.
+     * @param in Input values.
+     * @param out Receives size averages.
+     * @param size Number of values.
+     * @param window Number of values in each window.
+     */
+    static void meanFilter(const T* in, float* out, int size, int window);
+
+    /**
+     * @brief Replaces outliers with the median of their window.
+     * - A value is an outlier if it is more than threshold * 1.4826 * MAD from its window median,
+     *   the same rule as getHampelOutliers(). Other values pass through unchanged.
+     * - Window values are kept in a treap ordered by value with subtree sizes, one node per window slot,
+     *   so memory is O(window) however long the input is. The median is found by rank search and the MAD
+     *   by one descent of both halves of the treap, O(log window) expected per value.
+     * @param in Input values.
+     * @param out Receives size filtered values.
+     * @param size Number of values.
+     * @param window Number of values in each window.
+     * @param threshold Number of scaled MADs from the median. Default = 3.
+     * @return Number of values replaced.
+     */
+    static int hampelFilter(const T* in, T* out, int size, int window, float threshold = 3);
+
+private:
+    // Small integers cannot drift, everything else is summed in double.
+    typedef typename std::conditional<std::is_integral<T>::value && sizeof(T) <= 2,
+        int64_t, double>::type WindowSum;
+
+    /**
+     * @brief Order statistic tree of the window values. A treap with node slot + 1 for each window slot.
+     * - Nodes are ordered by value and then by node, so runs of equal values still form a random treap.
+     */
+    class OrderTree {
+    public:
+        OrderTree(int capacity);
+        void insert(int slot, T value);
+        void erase(int slot);
+        T select(int index) const;
+        double deviationMedian(T split, double center);
+
+    private:
+        struct Node {
+            T value;
+            uint32_t priority;
+            int left;   // Node index, 0 for none.
+            int right;  // Node index, 0 for none.
+            int size;   // Nodes in this subtree.
+        };
+
+        std::vector<Node> _nodes;  // _nodes[0] is the empty tree.
+        int _root;
+        uint32_t _random;
+
+        T _select(int node, int index) const;
+        double _distanceSelect(int lower, int upper, double center, int k) const;
+        void _resize(int node);
+        bool _before(int node, T value, int index) const;
+        void _split(int node, T value, int index, int& less, int& rest);
+        int _merge(int left, int right);
+        int _insert(int node, int item);
+        int _erase(int node, int item);
+    };
+};
+
+
+////////////////////////////////////////
+// VectorStatsFilters Implementation
+////////////////////////////////////////
+
+// The window ring keeps the outgoing values so in and out can share memory.
+template <typename T>
+void VectorStatsFilters<T>::medianFilter(const T* in, T* out, int size, int window) {
+    if (size <= 0) {
+        return;
+    }
+    if (window < 1) window = 1;
+    std::vector<T> ring(window, in[0]);
+    VectorStatsMedianHeap<T> heap;
+    heap.build(ring.data(), window);
+
+    int slot = 0;
+    for (int i = 0; i < size; ++i) {
+        T value = in[i];
+        ring[slot] = value;
+        heap.replace(slot, value);
+        if (++slot == window) slot = 0;
+        T right_mid = heap.rightMid();
+        out[i] = window % 2 ? right_mid : (heap.leftMid() + right_mid) / 2;
+    }
+}
+
+template <typename T>
+void VectorStatsFilters<T>::meanFilter(const T* in, float* out, int size, int window) {
+    if (size <= 0) {
+        return;
+    }
+    if (window < 1) window = 1;
+    std::vector<T> ring(window, in[0]);
+    WindowSum sum = (WindowSum)in[0] * window;
+
+    int slot = 0;
+    for (int i = 0; i < size; ++i) {
+        T value = in[i];
+        sum += (WindowSum)value - (WindowSum)ring[slot];
+        ring[slot] = value;
+        if (++slot == window) {
+            slot = 0;
+            if (!std::is_same<WindowSum, int64_t>::value) {
+                sum = 0;
+                for (T held : ring) sum += (WindowSum)held;
+            }
+        }
+        out[i] = (double)sum / window;
+    }
+}
+
+template <typename T>
+int VectorStatsFilters<T>::hampelFilter(const T* in, T* out, int size, int window, float threshold) {
+    if (size <= 0) {
+        return 0;
+    }
+    if (window < 1) window = 1;
+    OrderTree tree(window);
+    std::vector<T> ring(window, in[0]);
+    for (int i = 0; i < window; ++i) {
+        tree.insert(i, in[0]);
+    }
+
+    int mid = window / 2;
+    int replaced = 0;
+    int slot = 0;
+    for (int i = 0; i < size; ++i) {
+        T value = in[i];
+        tree.erase(slot);
+        tree.insert(slot, value);
+        ring[slot] = value;
+        if (++slot == window) slot = 0;
+
+        T right_mid = tree.select(mid);
+        T median = right_mid;
+        double center = right_mid;
+        if (window % 2 == 0) {
+            T left_mid = tree.select(mid - 1);
+            median = (left_mid + right_mid) / 2;
+            center = ((double)left_mid + right_mid) / 2;
+        }
+        double mad = tree.deviationMedian(right_mid, center);
+
+        if (std::fabs(value - center) > threshold * 1.4826 * mad) {
+            out[i] = median;
+            replaced++;
+        } else {
+            out[i] = value;
+        }
+    }
+    return replaced;
+}
+
+template <typename T>
+VectorStatsFilters<T>::OrderTree::OrderTree(int capacity)
+    : _nodes(capacity + 1), _root(0), _random(0x9E3779B9u) {
+    _nodes[0].size = 0;
+}
+
+template <typename T>
+void VectorStatsFilters<T>::OrderTree::insert(int slot, T value) {
+    int node = slot + 1;
+    _random ^= _random << 13;
+    _random ^= _random >> 17;
+    _random ^= _random << 5;
+    _nodes[node].value = value;
+    _nodes[node].priority = _random;
+    _nodes[node].left = 0;
+    _nodes[node].right = 0;
+    _nodes[node].size = 1;
+    _root = _insert(_root, node);
+}
+
+template <typename T>
+void VectorStatsFilters<T>::OrderTree::erase(int slot) {
+    _root = _erase(_root, slot + 1);
+}
+
+template <typename T>
+T VectorStatsFilters<T>::OrderTree::select(int index) const {
+    return _select(_root, index);
+}
+
+// Median of |value - center| over the whole tree, averaging the center two for even sizes like getMAD().
+// split is the right middle value. Values under it are at or under center and the rest at or over it,
+// so splitting there gives one treap per side of the center for _distanceSelect().
+template <typename T>
+double VectorStatsFilters<T>::OrderTree::deviationMedian(T split, double center) {
+    int size = _nodes[_root].size;
+    int lower = 0, upper = 0;
+    _split(_root, split, 0, lower, upper);
+    double mad = _distanceSelect(lower, upper, center, size / 2);
+    if (size % 2 == 0) {
+        mad = (mad + _distanceSelect(lower, upper, center, size / 2 - 1)) / 2;
+    }
+    _root = _merge(lower, upper);
+    return mad;
+}
+
+// Index-th smallest value of the subtree at node.
+template <typename T>
+T VectorStatsFilters<T>::OrderTree::_select(int node, int index) const {
+    while (true) {
+        int left_size = _nodes[_nodes[node].left].size;
+        if (index < left_size) {
+            node = _nodes[node].left;
+        } else if (index == left_size) {
+            return _nodes[node].value;
+        } else {
+            index -= left_size + 1;
+            node = _nodes[node].right;
+        }
+    }
+}
+
+// k-th smallest distance from center over two treaps, lower holding values under center and upper the rest.
+// Distances grow to the left in upper and to the right in lower. Each step compares the two roots and
+// drops one root together with the subtree on its far or near side, whichever the counts rule out,
+// so both treaps are walked down once. Equal distances count upper's value first.
+template <typename T>
+double VectorStatsFilters<T>::OrderTree::_distanceSelect(int lower, int upper, double center, int k) const {
+    while (lower != 0 && upper != 0) {
+        const Node& low = _nodes[lower];
+        const Node& high = _nodes[upper];
+        int low_near = _nodes[low.right].size;
+        int high_near = _nodes[high.left].size;
+        double low_distance = center - (double)low.value;
+        double high_distance = (double)high.value - center;
+        if (low_near + high_near < k) {
+            // The nearer root and its near side all rank at or before k - 1.
+            if (high_distance <= low_distance) {
+                k -= high_near + 1;
+                upper = high.right;
+            } else {
+                k -= low_near + 1;
+                lower = low.left;
+            }
+        } else if (low_distance >= high_distance) {
+            // The farther root and its far side all rank after k.
+            lower = low.right;
+        } else {
+            upper = high.left;
+        }
+    }
+    if (lower != 0) {
+        return center - (double)_select(lower, _nodes[lower].size - 1 - k);
+    }
+    return (double)_select(upper, k) - center;
+}
+
+template <typename T>
+void VectorStatsFilters<T>::OrderTree::_resize(int node) {
+    _nodes[node].size = _nodes[_nodes[node].left].size + _nodes[_nodes[node].right].size + 1;
+}
+
+// Whether node orders before the key (value, index). Index 0 orders before every node of that value.
+template <typename T>
+bool VectorStatsFilters<T>::OrderTree::_before(int node, T value, int index) const {
+    return _nodes[node].value < value || (!(value < _nodes[node].value) && node < index);
+}
+
+// less receives the nodes ordered before (value, index), rest the others.
+template <typename T>
+void VectorStatsFilters<T>::OrderTree::_split(int node, T value, int index, int& less, int& rest) {
+    if (node == 0) {
+        less = 0;
+        rest = 0;
+    } else if (_before(node, value, index)) {
+        _split(_nodes[node].right, value, index, _nodes[node].right, rest);
+        less = node;
+        _resize(node);
+    } else {
+        _split(_nodes[node].left, value, index, less, _nodes[node].left);
+        rest = node;
+        _resize(node);
+    }
+}
+
+// Every value of left is at or under every value of right.
+template <typename T>
+int VectorStatsFilters<T>::OrderTree::_merge(int left, int right) {
+    if (left == 0 || right == 0) {
+        return left ? left : right;
+    }
+    if (_nodes[left].priority > _nodes[right].priority) {
+        _nodes[left].right = _merge(_nodes[left].right, right);
+        _resize(left);
+        return left;
+    }
+    _nodes[right].left = _merge(left, _nodes[right].left);
+    _resize(right);
+    return right;
+}
+
+// Walks down to where item's priority belongs and splits the rest of that subtree under it.
+template <typename T>
+int VectorStatsFilters<T>::OrderTree::_insert(int node, int item) {
+    if (node == 0) {
+        return item;
+    }
+    if (_nodes[item].priority > _nodes[node].priority) {
+        _split(node, _nodes[item].value, item, _nodes[item].left, _nodes[item].right);
+        _resize(item);
+        return item;
+    }
+    if (_before(item, _nodes[node].value, node)) {
+        _nodes[node].left = _insert(_nodes[node].left, item);
+    } else {
+        _nodes[node].right = _insert(_nodes[node].right, item);
+    }
+    _resize(node);
+    return node;
+}
+
+// Removes item, found by its (value, node) key.
+template <typename T>
+int VectorStatsFilters<T>::OrderTree::_erase(int node, int item) {
+    if (node == 0) {
+        return 0;
+    }
+    if (node == item) {
+        return _merge(_nodes[node].left, _nodes[node].right);
+    }
+    if (_before(item, _nodes[node].value, node)) {
+        _nodes[node].left = _erase(_nodes[node].left, item);
+    } else {
+        _nodes[node].right = _erase(_nodes[node].right, item);
+    }
+    _resize(node);
+    return node;
+}
+
+#endif
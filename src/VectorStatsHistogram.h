@@ -0,0 +1,157 @@
+/**
+ * @file VectorStatsHistogram.h
+ * @brief This header file contains the counting histogram used by VectorStats for integer ranks.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_HISTOGRAM_H
+#define VECTORSTATS_HISTOGRAM_H
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "VectorStatsConfig.h"
+
+/**
+ * @class VectorStatsHistogram
+ * @brief Counting histogram over a declared integer range with a coarse block index.
+ * - Every value has its own bin. Every 64 bins also share a block count.
+ * - Replacing a value is O(1). Finding any rank walks blocks then bins.
+ * - A 12 bit range of 4096 bins needs at most 64 block steps and 64 bin steps.
+ * - Values outside of the range are counted in the first or last bin.
+ * - Ranges are limited to max_bins values. fits() checks a range without overflowing int.
+ * @tparam T An integer data type.
+ */
+template <typename T>
+class VectorStatsHistogram {
+public:
+    static const int max_bins = 1 << 20;  // 4MB of bins.
+
+    /**
+     * @brief Checks that a range is ordered and no wider than max_bins values.
+     */
+    static VECTORSTATS_CONSTEXPR bool fits(T min_value, T max_value);
+
+    /**
+     * @brief Clamps a value to the limits of T, e.g. 4095 becomes 127 for int8_t.
+     */
+    static VECTORSTATS_CONSTEXPR T clampValue(long value);
+
+    /**
+     * @brief Recounts every bin from a buffer.
+     * @param data Pointer to the first buffer element.
+     * @param size Number of elements in the buffer.
+     * @param min_value Smallest value with its own bin.
+     * @param max_value Largest value with its own bin.
+     * - The range must pass fits().
+     */
+    VECTORSTATS_CONSTEXPR void build(const T* data, int size, T min_value, T max_value);
+
+    /**
+     * @brief Moves one count from the bin of old_value to the bin of new_value.
+     */
+    VECTORSTATS_CONSTEXPR void replace(T old_value, T new_value);
+
+    /**
+     * @brief Finds the value at a sorted index.
+     * @param rank Sorted index from 0 to size - 1.
+     * @return Value at rank. Clamped to the histogram range.
+     */
+    VECTORSTATS_CONSTEXPR T rank(int rank) const;
+
+    /**
+     * @brief Releases all memory held by the histogram.
+     */
+    VECTORSTATS_CONSTEXPR void clear();
+
+private:
+    static const int _block_bits = 6;  // 64 bins per block.
+
+    std::vector<int> _bins;
+    std::vector<int> _blocks;
+    T _min_value = 0;
+    T _max_value = 0;
+
+    VECTORSTATS_CONSTEXPR int _bin(T value) const;
+};
+
+
+////////////////////////////////////////
+// VectorStatsHistogram Implementation
+////////////////////////////////////////
+
+// The span is taken in 64 bits, so a full 32 bit range is rejected instead of overflowing.
+template <typename T>
+VECTORSTATS_CONSTEXPR bool VectorStatsHistogram<T>::fits(T min_value, T max_value) {
+    if (max_value < min_value) {
+        return false;
+    }
+    if (std::is_integral<T>::value) {
+        return (uint64_t)max_value - (uint64_t)min_value < (uint64_t)max_bins;
+    }
+    return (double)max_value - (double)min_value < max_bins;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsHistogram<T>::clampValue(long value) {
+    if ((double)value > (double)std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+    if ((double)value < (double)std::numeric_limits<T>::lowest()) return std::numeric_limits<T>::lowest();
+    return (T)value;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsHistogram<T>::build(const T* data, int size, T min_value, T max_value) {
+    _min_value = min_value;
+    _max_value = max_value;
+    int bins = (int)(max_value - min_value) + 1;
+    _bins.assign(bins, 0);
+    _blocks.assign((bins >> _block_bits) + 1, 0);
+    for (int i = 0; i < size; ++i) {
+        int bin = _bin(data[i]);
+        _bins[bin]++;
+        _blocks[bin >> _block_bits]++;
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsHistogram<T>::replace(T old_value, T new_value) {
+    int old_bin = _bin(old_value);
+    int new_bin = _bin(new_value);
+    _bins[old_bin]--;
+    _blocks[old_bin >> _block_bits]--;
+    _bins[new_bin]++;
+    _blocks[new_bin >> _block_bits]++;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsHistogram<T>::rank(int rank) const {
+    int block = 0;
+    while (rank >= _blocks[block]) {
+        rank -= _blocks[block];
+        block++;
+    }
+    int bin = block << _block_bits;
+    while (rank >= _bins[bin]) {
+        rank -= _bins[bin];
+        bin++;
+    }
+    return (T)(_min_value + bin);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsHistogram<T>::clear() {
+    std::vector<int>().swap(_bins);
+    std::vector<int>().swap(_blocks);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR int VectorStatsHistogram<T>::_bin(T value) const {
+    if (value < _min_value) return 0;
+    if (value > _max_value) return (int)(_max_value - _min_value);
+    return (int)(value - _min_value);
+}
+
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file VectorStatsInstrumentation.h
+ * @brief This header file contains the instrumentation policies that VectorStats reports its hot paths to.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_INSTRUMENTATION_H
+#define VECTORSTATS_INSTRUMENTATION_H
+
+#include <cstdint>
+#include <chrono>
+#include "VectorStatsConfig.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define VECTORSTATS_HAS_TSC 1
+#endif
+
+/**
+ * @brief Methods that VectorStats reports to its instrumentation.
+ */
+enum class VectorStatsMethod : uint8_t {
+    add,
+    addBatch,
+    getMedian,
+    getSortedElement,
+    getQuantiles,
+    getAverage,
+    getStdDev,
+    getOutliers,
+    getSlope,
+    getSummary,
+    count  // Number of methods, not a method.
+};
+
+/**
+ * @struct VectorStatsNoInstrumentation
+ * @brief Default instrumentation. Every hook is empty and inlines away.
+ * - VectorStats inherits it, so the empty base takes no memory.
+ */
+struct VectorStatsNoInstrumentation {
+    /**
+     * @brief Marks one call of a method for as long as it is in scope.
+     */
+    struct Scope {
+        VECTORSTATS_CONSTEXPR Scope(const VectorStatsNoInstrumentation&, VectorStatsMethod) {}
+    };
+
+    VECTORSTATS_CONSTEXPR void touched(VectorStatsMethod, int) const {}
+    VECTORSTATS_CONSTEXPR void sortedHit(VectorStatsMethod) const {}
+    VECTORSTATS_CONSTEXPR void sortedMiss(VectorStatsMethod, bool) const {}
+};
+
+/**
+ * @struct VectorStatsMethodCounters
+ * @brief Counters of one method.
+ */
+struct VectorStatsMethodCounters {
+    uint64_t calls = 0;          // Times the method was called, including calls from other methods.
+    uint64_t ticks = 0;          // Time inside the method. TSC cycles on x86, nanoseconds elsewhere.
+    uint64_t elements = 0;       // Buffer elements read or written. O(1) paths add none.
+    uint64_t sorted_hits = 0;    // Calls answered from an already sorted buffer.
+    uint64_t sorted_misses = 0;  // Calls that had to select or sort first.
+};
+
+/**
+ * @class VectorStatsCounters
+ * @brief Instrumentation that counts calls, ticks, elements and sort work of every method.
+ * - Select it with VectorStatsPolicy<double, float, VectorStatsCounters>.
+ * - Read it with getInstrumentation().snapshot() as often as needed.
+ * - Not thread safe. Snapshot from the thread that uses the buffer.
+ */
+class VectorStatsCounters {
+public:
+    static const int method_count = (int)VectorStatsMethod::count;
+
+    /**
+     * @struct Snapshot
+     * @brief Copy of all counters at one moment.
+     */
+    struct Snapshot {
+        VectorStatsMethodCounters methods[method_count];
+        uint64_t selections = 0;  // nth_element and multi-select passes that partly reordered the buffer.
+        uint64_t full_sorts = 0;  // std::sort passes over the whole buffer.
+
+        /**
+         * @brief Gets the counters of one method.
+         */
+        VECTORSTATS_CONSTEXPR const VectorStatsMethodCounters& operator[](VectorStatsMethod method) const {
+            return methods[(int)method];
+        }
+    };
+
+    struct Scope {
+        VECTORSTATS_CONSTEXPR Scope(const VectorStatsCounters& counters, VectorStatsMethod method)
+            : _counters(counters), _method((int)method), _start(0) {
+            _counters._counts.methods[_method].calls++;
+            if (!VECTORSTATS_IS_CONSTANT_EVALUATED()) _start = ticks();
+        }
+
+        VECTORSTATS_CONSTEXPR ~Scope() {
+            if (!VECTORSTATS_IS_CONSTANT_EVALUATED()) _counters._counts.methods[_method].ticks += ticks() - _start;
+        }
+
+    private:
+        const VectorStatsCounters& _counters;
+        int _method;
+        uint64_t _start;
+    };
+
+    VECTORSTATS_CONSTEXPR void touched(VectorStatsMethod method, int elements) const {
+        _counts.methods[(int)method].elements += elements;
+    }
+
+    VECTORSTATS_CONSTEXPR void sortedHit(VectorStatsMethod method) const {
+        _counts.methods[(int)method].sorted_hits++;
+    }
+
+    VECTORSTATS_CONSTEXPR void sortedMiss(VectorStatsMethod method, bool full_sort) const {
+        _counts.methods[(int)method].sorted_misses++;
+        if (full_sort) {
+            _counts.full_sorts++;
+        } else {
+            _counts.selections++;
+        }
+    }
+
+    /**
+     * @brief Copies every counter.
+     */
+    VECTORSTATS_CONSTEXPR Snapshot snapshot() const { return _counts; }
+
+    /**
+     * @brief Sets every counter to zero.
+     */
+    VECTORSTATS_CONSTEXPR void reset() { _counts = Snapshot(); }
+
+    /**
+     * @brief Gets the name of a method for printing.
+     */
+    static const char* methodName(VectorStatsMethod method) {
+        static const char* const names[method_count] = {
+            "add", "addBatch", "getMedian", "getSortedElement", "getQuantiles",
+            "getAverage", "getStdDev", "getOutliers", "getSlope", "getSummary"};
+        return (int)method < method_count ? names[(int)method] : "";
+    }
+
+    /**
+     * @brief Reads the clock used for ticks.
+     */
+    static uint64_t ticks() {
+#if defined(VECTORSTATS_HAS_TSC)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+private:
+    // Statistics such as getAverage() are const, so the counters they bump are mutable.
+    mutable Snapshot _counts;
+};
+
+
+#endif
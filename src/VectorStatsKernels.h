@@ -0,0 +1,538 @@
+/**
+ * @file VectorStatsKernels.h
+ * @brief This header file contains the reduction kernels used by the VectorStats statistics.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_KERNELS_H
+#define VECTORSTATS_KERNELS_H
+
+#include <cstdint>
+#include <cmath>
+#include "VectorStatsConfig.h"
+
+#if defined(VECTORSTATS_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(VECTORSTATS_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(VECTORSTATS_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @class VectorStatsScalarKernels
+ * @brief Portable reductions over a contiguous range.
+ * - Four independent accumulators break the add dependency chain so the compiler can pipeline or vectorize.
+ * - Usable in constant expressions with C++20.
+ * @tparam T The data type of the buffer elements.
+ */
+template <typename T>
+struct VectorStatsScalarKernels {
+    /**
+     * @brief Sums a range.
+     * @return Sum as a double.
+     */
+    static VECTORSTATS_CONSTEXPR double sum(const T* data, int size) {
+        double lane[4] = {0.0, 0.0, 0.0, 0.0};
+        int i = 0;
+        for (; i + 4 <= size; i += 4) {
+            lane[0] += data[i];
+            lane[1] += data[i + 1];
+            lane[2] += data[i + 2];
+            lane[3] += data[i + 3];
+        }
+        for (; i < size; ++i) lane[0] += data[i];
+        return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    }
+
+    /**
+     * @brief Sums the squared distance of every element from center.
+     * @return Sum of (value - center)^2 as a double.
+     */
+    static VECTORSTATS_CONSTEXPR double sumSquaredDeviations(const T* data, int size, double center) {
+        double lane[4] = {0.0, 0.0, 0.0, 0.0};
+        int i = 0;
+        for (; i + 4 <= size; i += 4) {
+            double d0 = data[i] - center, d1 = data[i + 1] - center;
+            double d2 = data[i + 2] - center, d3 = data[i + 3] - center;
+            lane[0] += d0 * d0;
+            lane[1] += d1 * d1;
+            lane[2] += d2 * d2;
+            lane[3] += d3 * d3;
+        }
+        for (; i < size; ++i) lane[0] += (data[i] - center) * (data[i] - center);
+        return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    }
+
+    /**
+     * @brief Sums a range and the squared distance of every element from center in one pass.
+     */
+    static VECTORSTATS_CONSTEXPR void moments(const T* data, int size, double center, double& total, double& squares) {
+        double lane[4] = {0.0, 0.0, 0.0, 0.0};
+        double square_lane[4] = {0.0, 0.0, 0.0, 0.0};
+        int i = 0;
+        for (; i + 4 <= size; i += 4) {
+            double d0 = data[i] - center, d1 = data[i + 1] - center;
+            double d2 = data[i + 2] - center, d3 = data[i + 3] - center;
+            lane[0] += data[i];
+            lane[1] += data[i + 1];
+            lane[2] += data[i + 2];
+            lane[3] += data[i + 3];
+            square_lane[0] += d0 * d0;
+            square_lane[1] += d1 * d1;
+            square_lane[2] += d2 * d2;
+            square_lane[3] += d3 * d3;
+        }
+        for (; i < size; ++i) {
+            lane[0] += data[i];
+            square_lane[0] += (data[i] - center) * (data[i] - center);
+        }
+        total = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+        squares = (square_lane[0] + square_lane[1]) + (square_lane[2] + square_lane[3]);
+    }
+
+    /**
+     * @brief Finds the smallest and largest element of a non-empty range.
+     */
+    static VECTORSTATS_CONSTEXPR void minMax(const T* data, int size, T& min_value, T& max_value) {
+        T low = data[0], high = data[0];
+        for (int i = 1; i < size; ++i) {
+            if (data[i] < low) low = data[i];
+            if (high < data[i]) high = data[i];
+        }
+        min_value = low;
+        max_value = high;
+    }
+
+    /**
+     * @brief Counts elements strictly below low or strictly above high.
+     */
+    static VECTORSTATS_CONSTEXPR int countOutside(const T* data, int size, double low, double high) {
+        int lane[4] = {0, 0, 0, 0};
+        int i = 0;
+        for (; i + 4 <= size; i += 4) {
+            lane[0] += (data[i] < low) | (data[i] > high);
+            lane[1] += (data[i + 1] < low) | (data[i + 1] > high);
+            lane[2] += (data[i + 2] < low) | (data[i + 2] > high);
+            lane[3] += (data[i + 3] < low) | (data[i + 3] > high);
+        }
+        for (; i < size; ++i) lane[0] += (data[i] < low) | (data[i] > high);
+        return lane[0] + lane[1] + lane[2] + lane[3];
+    }
+
+    /**
+     * @brief Sums every element weighted by its position from 1 to size.
+     * @return Sum of (i + 1) * data[i] as a double.
+     */
+    static VECTORSTATS_CONSTEXPR double weightedSum(const T* data, int size) {
+        double lane[4] = {0.0, 0.0, 0.0, 0.0};
+        int i = 0;
+        for (; i + 4 <= size; i += 4) {
+            lane[0] += (double)(i + 1) * data[i];
+            lane[1] += (double)(i + 2) * data[i + 1];
+            lane[2] += (double)(i + 3) * data[i + 2];
+            lane[3] += (double)(i + 4) * data[i + 3];
+        }
+        for (; i < size; ++i) lane[0] += (double)(i + 1) * data[i];
+        return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    }
+};
+
+/**
+ * @class VectorStatsKernels
+ * @brief Reductions used by VectorStats. Dispatches to SIMD where the type and target allow.
+ * @tparam T The data type of the buffer elements.
+ */
+template <typename T>
+struct VectorStatsKernels : VectorStatsScalarKernels<T> {};
+
+
+#if defined(VECTORSTATS_SIMD_AVX2) || defined(VECTORSTATS_SIMD_SSE2) || defined(VECTORSTATS_SIMD_NEON)
+
+/**
+ * @class VectorStatsKernels<int16_t>
+ * @brief SIMD reductions for analogRead sized data.
+ * - Values are summed exactly in 32 bit lanes that are widened to 64 bits before they can overflow.
+ * - Falls back to the scalar kernels during constant evaluation.
+ */
+template <>
+struct VectorStatsKernels<int16_t> {
+    typedef VectorStatsScalarKernels<int16_t> Scalar;
+
+    static VECTORSTATS_CONSTEXPR double sum(const int16_t* data, int size) {
+        if (VECTORSTATS_IS_CONSTANT_EVALUATED()) return Scalar::sum(data, size);
+        int64_t total = 0, squares = 0;
+        _sumAndSquares(data, size, total, squares);
+        return (double)total;
+    }
+
+    // Exact integer sums make the expanded form safe: sum(x^2) - 2c sum(x) + n c^2.
+    static VECTORSTATS_CONSTEXPR double sumSquaredDeviations(const int16_t* data, int size, double center) {
+        if (VECTORSTATS_IS_CONSTANT_EVALUATED()) return Scalar::sumSquaredDeviations(data, size, center);
+        int64_t total = 0, squares = 0;
+        _sumAndSquares(data, size, total, squares);
+        double deviations = (double)squares - 2.0 * center * (double)total + size * center * center;
+        return deviations > 0 ? deviations : 0.0;
+    }
+
+    static VECTORSTATS_CONSTEXPR void moments(const int16_t* data, int size, double center, double& total, double& squares) {
+        if (VECTORSTATS_IS_CONSTANT_EVALUATED()) return Scalar::moments(data, size, center, total, squares);
+        int64_t exact_total = 0, exact_squares = 0;
+        _sumAndSquares(data, size, exact_total, exact_squares);
+        double deviations = (double)exact_squares - 2.0 * center * (double)exact_total + size * center * center;
+        total = (double)exact_total;
+        squares = deviations > 0 ? deviations : 0.0;
+    }
+
+    static VECTORSTATS_CONSTEXPR void minMax(const int16_t* data, int size, int16_t& min_value, int16_t& max_value) {
+        if (VECTORSTATS_IS_CONSTANT_EVALUATED()) return Scalar::minMax(data, size, min_value, max_value);
+        _minMax(data, size, min_value, max_value);
+    }
+
+    // For integers x < low is x < ceil(low) and x > high is x > floor(high).
+    static VECTORSTATS_CONSTEXPR int countOutside(const int16_t* data, int size, double low, double high) {
+        if (VECTORSTATS_IS_CONSTANT_EVALUATED()) return Scalar::countOutside(data, size, low, high);
+        if (low != low || high != high) return 0;
+        if (low > INT16_MAX || high < INT16_MIN) return size;
+        double low_bound = std::ceil(low), high_bound = std::floor(high);
+        int16_t low_int = low_bound < INT16_MIN ? INT16_MIN : (int16_t)low_bound;
+        int16_t high_int = high_bound > INT16_MAX ? INT16_MAX : (int16_t)high_bound;
+        return _countOutside(data, size, low_int, high_int);
+    }
+
+    static VECTORSTATS_CONSTEXPR double weightedSum(const int16_t* data, int size) {
+        if (VECTORSTATS_IS_CONSTANT_EVALUATED()) return Scalar::weightedSum(data, size);
+        return (double)_weightedSum(data, size);
+    }
+
+private:
+    static const int _block = 16384;  // Keeps 32 bit partial sums and 16 bit positions in range.
+
+#if defined(VECTORSTATS_SIMD_AVX2)
+
+    static int64_t _horizontal(__m256i v) {
+        int64_t lanes[4];
+        _mm256_storeu_si256((__m256i*)lanes, v);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    static __m256i _widenAdd(__m256i acc64, __m256i v32) {
+        acc64 = _mm256_add_epi64(acc64, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v32)));
+        return _mm256_add_epi64(acc64, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v32, 1)));
+    }
+
+    static void _sumAndSquares(const int16_t* data, int size, int64_t& total, int64_t& squares) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum64 = _mm256_setzero_si256(), sq64 = _mm256_setzero_si256();
+        int i = 0;
+        while (i + 16 <= size) {
+            int block_end = (size - i > _block) ? i + _block : size;
+            __m256i sum32 = _mm256_setzero_si256();
+            for (; i + 16 <= block_end; i += 16) {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(data + i));
+                sum32 = _mm256_add_epi32(sum32, _mm256_madd_epi16(x, ones));
+                __m256i sq = _mm256_madd_epi16(x, x);  // Up to 2^31, so widen unsigned.
+                sq64 = _mm256_add_epi64(sq64, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(sq)));
+                sq64 = _mm256_add_epi64(sq64, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(sq, 1)));
+            }
+            sum64 = _widenAdd(sum64, sum32);
+        }
+        total = _horizontal(sum64);
+        squares = _horizontal(sq64);
+        for (; i < size; ++i) {
+            total += data[i];
+            squares += (int32_t)data[i] * data[i];
+        }
+    }
+
+    static void _minMax(const int16_t* data, int size, int16_t& min_value, int16_t& max_value) {
+        int16_t low = data[0], high = data[0];
+        int i = 0;
+        if (size >= 16) {
+            __m256i vlow = _mm256_loadu_si256((const __m256i*)data), vhigh = vlow;
+            for (i = 16; i + 16 <= size; i += 16) {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(data + i));
+                vlow = _mm256_min_epi16(vlow, x);
+                vhigh = _mm256_max_epi16(vhigh, x);
+            }
+            int16_t lows[16], highs[16];
+            _mm256_storeu_si256((__m256i*)lows, vlow);
+            _mm256_storeu_si256((__m256i*)highs, vhigh);
+            for (int lane = 0; lane < 16; ++lane) {
+                if (lows[lane] < low) low = lows[lane];
+                if (highs[lane] > high) high = highs[lane];
+            }
+        }
+        for (; i < size; ++i) {
+            if (data[i] < low) low = data[i];
+            if (data[i] > high) high = data[i];
+        }
+        min_value = low;
+        max_value = high;
+    }
+
+    static int _countOutside(const int16_t* data, int size, int16_t low, int16_t high) {
+        const __m256i vlow = _mm256_set1_epi16(low), vhigh = _mm256_set1_epi16(high);
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i count32 = _mm256_setzero_si256();
+        int i = 0;
+        while (i + 16 <= size) {
+            int block_end = (size - i > _block) ? i + _block : size;
+            __m256i count16 = _mm256_setzero_si256();
+            for (; i + 16 <= block_end; i += 16) {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi16(vlow, x), _mm256_cmpgt_epi16(x, vhigh));
+                count16 = _mm256_sub_epi16(count16, outside);  // Masks are -1.
+            }
+            count32 = _mm256_add_epi32(count32, _mm256_madd_epi16(count16, ones));
+        }
+        int32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, count32);
+        int count = 0;
+        for (int lane = 0; lane < 8; ++lane) count += lanes[lane];
+        for (; i < size; ++i) count += (data[i] < low) | (data[i] > high);
+        return count;
+    }
+
+    // Sum of (base + j + 1) x = (base + 1) sum(x) + sum(j x) with j kept below 2^14.
+    static int64_t _weightedSum(const int16_t* data, int size) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        const __m256i step = _mm256_set1_epi16(16);
+        int64_t total = 0;
+        int i = 0;
+        while (i + 16 <= size) {
+            int base = i;
+            int block_end = (size - i > _block) ? i + _block : size;
+            __m256i position = _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            __m256i sum32 = _mm256_setzero_si256();
+            __m256i weighted64 = _mm256_setzero_si256();
+            for (; i + 16 <= block_end; i += 16) {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(data + i));
+                sum32 = _mm256_add_epi32(sum32, _mm256_madd_epi16(x, ones));
+                weighted64 = _widenAdd(weighted64, _mm256_madd_epi16(x, position));
+                position = _mm256_add_epi16(position, step);
+            }
+            total += (int64_t)(base + 1) * _horizontal(_widenAdd(_mm256_setzero_si256(), sum32));
+            total += _horizontal(weighted64);
+        }
+        for (; i < size; ++i) total += (int64_t)(i + 1) * data[i];
+        return total;
+    }
+
+#elif defined(VECTORSTATS_SIMD_SSE2)
+
+    static int64_t _horizontal(__m128i v) {
+        int64_t lanes[2];
+        _mm_storeu_si128((__m128i*)lanes, v);
+        return lanes[0] + lanes[1];
+    }
+
+    static __m128i _widenAdd(__m128i acc64, __m128i v32) {
+        __m128i sign = _mm_srai_epi32(v32, 31);
+        acc64 = _mm_add_epi64(acc64, _mm_unpacklo_epi32(v32, sign));
+        return _mm_add_epi64(acc64, _mm_unpackhi_epi32(v32, sign));
+    }
+
+    static void _sumAndSquares(const int16_t* data, int size, int64_t& total, int64_t& squares) {
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum64 = zero, sq64 = zero;
+        int i = 0;
+        while (i + 8 <= size) {
+            int block_end = (size - i > _block) ? i + _block : size;
+            __m128i sum32 = zero;
+            for (; i + 8 <= block_end; i += 8) {
+                __m128i x = _mm_loadu_si128((const __m128i*)(data + i));
+                sum32 = _mm_add_epi32(sum32, _mm_madd_epi16(x, ones));
+                __m128i sq = _mm_madd_epi16(x, x);  // Up to 2^31, so widen unsigned.
+                sq64 = _mm_add_epi64(sq64, _mm_unpacklo_epi32(sq, zero));
+                sq64 = _mm_add_epi64(sq64, _mm_unpackhi_epi32(sq, zero));
+            }
+            sum64 = _widenAdd(sum64, sum32);
+        }
+        total = _horizontal(sum64);
+        squares = _horizontal(sq64);
+        for (; i < size; ++i) {
+            total += data[i];
+            squares += (int32_t)data[i] * data[i];
+        }
+    }
+
+    static void _minMax(const int16_t* data, int size, int16_t& min_value, int16_t& max_value) {
+        int16_t low = data[0], high = data[0];
+        int i = 0;
+        if (size >= 8) {
+            __m128i vlow = _mm_loadu_si128((const __m128i*)data), vhigh = vlow;
+            for (i = 8; i + 8 <= size; i += 8) {
+                __m128i x = _mm_loadu_si128((const __m128i*)(data + i));
+                vlow = _mm_min_epi16(vlow, x);
+                vhigh = _mm_max_epi16(vhigh, x);
+            }
+            int16_t lows[8], highs[8];
+            _mm_storeu_si128((__m128i*)lows, vlow);
+            _mm_storeu_si128((__m128i*)highs, vhigh);
+            for (int lane = 0; lane < 8; ++lane) {
+                if (lows[lane] < low) low = lows[lane];
+                if (highs[lane] > high) high = highs[lane];
+            }
+        }
+        for (; i < size; ++i) {
+            if (data[i] < low) low = data[i];
+            if (data[i] > high) high = data[i];
+        }
+        min_value = low;
+        max_value = high;
+    }
+
+    static int _countOutside(const int16_t* data, int size, int16_t low, int16_t high) {
+        const __m128i vlow = _mm_set1_epi16(low), vhigh = _mm_set1_epi16(high);
+        const __m128i ones = _mm_set1_epi16(1);
+        __m128i count32 = _mm_setzero_si128();
+        int i = 0;
+        while (i + 8 <= size) {
+            int block_end = (size - i > _block) ? i + _block : size;
+            __m128i count16 = _mm_setzero_si128();
+            for (; i + 8 <= block_end; i += 8) {
+                __m128i x = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i outside = _mm_or_si128(_mm_cmplt_epi16(x, vlow), _mm_cmpgt_epi16(x, vhigh));
+                count16 = _mm_sub_epi16(count16, outside);  // Masks are -1.
+            }
+            count32 = _mm_add_epi32(count32, _mm_madd_epi16(count16, ones));
+        }
+        int32_t lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, count32);
+        int count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        for (; i < size; ++i) count += (data[i] < low) | (data[i] > high);
+        return count;
+    }
+
+    // Sum of (base + j + 1) x = (base + 1) sum(x) + sum(j x) with j kept below 2^14.
+    static int64_t _weightedSum(const int16_t* data, int size) {
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128i step = _mm_set1_epi16(8);
+        int64_t total = 0;
+        int i = 0;
+        while (i + 8 <= size) {
+            int base = i;
+            int block_end = (size - i > _block) ? i + _block : size;
+            __m128i position = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+            __m128i sum32 = _mm_setzero_si128();
+            __m128i weighted64 = _mm_setzero_si128();
+            for (; i + 8 <= block_end; i += 8) {
+                __m128i x = _mm_loadu_si128((const __m128i*)(data + i));
+                sum32 = _mm_add_epi32(sum32, _mm_madd_epi16(x, ones));
+                weighted64 = _widenAdd(weighted64, _mm_madd_epi16(x, position));
+                position = _mm_add_epi16(position, step);
+            }
+            total += (int64_t)(base + 1) * _horizontal(_widenAdd(_mm_setzero_si128(), sum32));
+            total += _horizontal(weighted64);
+        }
+        for (; i < size; ++i) total += (int64_t)(i + 1) * data[i];
+        return total;
+    }
+
+#elif defined(VECTORSTATS_SIMD_NEON)
+
+    static void _sumAndSquares(const int16_t* data, int size, int64_t& total, int64_t& squares) {
+        int64x2_t sum64 = vdupq_n_s64(0), sq64 = vdupq_n_s64(0);
+        int i = 0;
+        while (i + 8 <= size) {
+            int block_end = (size - i > _block) ? i + _block : size;
+            int32x4_t sum32 = vdupq_n_s32(0);
+            for (; i + 8 <= block_end; i += 8) {
+                int16x8_t x = vld1q_s16(data + i);
+                sum32 = vpadalq_s16(sum32, x);
+                sq64 = vpadalq_s32(sq64, vmull_s16(vget_low_s16(x), vget_low_s16(x)));
+                sq64 = vpadalq_s32(sq64, vmull_s16(vget_high_s16(x), vget_high_s16(x)));
+            }
+            sum64 = vpadalq_s32(sum64, sum32);
+        }
+        total = vgetq_lane_s64(sum64, 0) + vgetq_lane_s64(sum64, 1);
+        squares = vgetq_lane_s64(sq64, 0) + vgetq_lane_s64(sq64, 1);
+        for (; i < size; ++i) {
+            total += data[i];
+            squares += (int32_t)data[i] * data[i];
+        }
+    }
+
+    static void _minMax(const int16_t* data, int size, int16_t& min_value, int16_t& max_value) {
+        int16_t low = data[0], high = data[0];
+        int i = 0;
+        if (size >= 8) {
+            int16x8_t vlow = vld1q_s16(data), vhigh = vlow;
+            for (i = 8; i + 8 <= size; i += 8) {
+                int16x8_t x = vld1q_s16(data + i);
+                vlow = vminq_s16(vlow, x);
+                vhigh = vmaxq_s16(vhigh, x);
+            }
+            int16_t lows[8], highs[8];
+            vst1q_s16(lows, vlow);
+            vst1q_s16(highs, vhigh);
+            for (int lane = 0; lane < 8; ++lane) {
+                if (lows[lane] < low) low = lows[lane];
+                if (highs[lane] > high) high = highs[lane];
+            }
+        }
+        for (; i < size; ++i) {
+            if (data[i] < low) low = data[i];
+            if (data[i] > high) high = data[i];
+        }
+        min_value = low;
+        max_value = high;
+    }
+
+    static int _countOutside(const int16_t* data, int size, int16_t low, int16_t high) {
+        const int16x8_t vlow = vdupq_n_s16(low), vhigh = vdupq_n_s16(high);
+        uint32x4_t count32 = vdupq_n_u32(0);
+        int i = 0;
+        while (i + 8 <= size) {
+            int block_end = (size - i > _block) ? i + _block : size;
+            uint16x8_t count16 = vdupq_n_u16(0);
+            for (; i + 8 <= block_end; i += 8) {
+                int16x8_t x = vld1q_s16(data + i);
+                uint16x8_t outside = vorrq_u16(vcltq_s16(x, vlow), vcgtq_s16(x, vhigh));
+                count16 = vsubq_u16(count16, outside);  // Masks are all ones.
+            }
+            count32 = vpadalq_u16(count32, count16);
+        }
+        int count = vgetq_lane_u32(count32, 0) + vgetq_lane_u32(count32, 1) +
+                    vgetq_lane_u32(count32, 2) + vgetq_lane_u32(count32, 3);
+        for (; i < size; ++i) count += (data[i] < low) | (data[i] > high);
+        return count;
+    }
+
+    // Sum of (base + j + 1) x = (base + 1) sum(x) + sum(j x) with j kept below 2^14.
+    static int64_t _weightedSum(const int16_t* data, int size) {
+        static const int16_t start[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+        const int16x8_t step = vdupq_n_s16(8);
+        int64_t total = 0;
+        int i = 0;
+        while (i + 8 <= size) {
+            int base = i;
+            int block_end = (size - i > _block) ? i + _block : size;
+            int16x8_t position = vld1q_s16(start);
+            int32x4_t sum32 = vdupq_n_s32(0);
+            int64x2_t weighted64 = vdupq_n_s64(0);
+            for (; i + 8 <= block_end; i += 8) {
+                int16x8_t x = vld1q_s16(data + i);
+                sum32 = vpadalq_s16(sum32, x);
+                weighted64 = vpadalq_s32(weighted64, vmull_s16(vget_low_s16(x), vget_low_s16(position)));
+                weighted64 = vpadalq_s32(weighted64, vmull_s16(vget_high_s16(x), vget_high_s16(position)));
+                position = vaddq_s16(position, step);
+            }
+            int64x2_t block_sum = vpaddlq_s32(sum32);
+            total += (int64_t)(base + 1) * (vgetq_lane_s64(block_sum, 0) + vgetq_lane_s64(block_sum, 1));
+            total += vgetq_lane_s64(weighted64, 0) + vgetq_lane_s64(weighted64, 1);
+        }
+        for (; i < size; ++i) total += (int64_t)(i + 1) * data[i];
+        return total;
+    }
+
+#endif
+};
+
+#endif
+
+
+#endif
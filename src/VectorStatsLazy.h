@@ -0,0 +1,117 @@
+/**
+ * @file VectorStatsLazy.h
+ * @brief This header file contains the owner of optional state that VectorStats allocates on first use.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_LAZY_H
+#define VECTORSTATS_LAZY_H
+
+#include <utility>
+#include "VectorStatsConfig.h"
+
+/**
+ * @class VectorStatsLazy
+ * @brief Owns one E that is only allocated the first time get() is called.
+ * - Costs one pointer until then, so state that is never used costs no memory.
+ * - Copies are deep. Moves hand the allocation over.
+ * - With C++20 it can be used in constant expressions as long as it is destroyed within them.
+ * @tparam E The owned type. Must be default constructible and copyable.
+ */
+template <typename E>
+class VectorStatsLazy {
+public:
+    VECTORSTATS_CONSTEXPR VectorStatsLazy();
+    VECTORSTATS_CONSTEXPR VectorStatsLazy(const VectorStatsLazy& other);
+    VECTORSTATS_CONSTEXPR VectorStatsLazy(VectorStatsLazy&& other) noexcept;
+    VECTORSTATS_CONSTEXPR VectorStatsLazy& operator=(VectorStatsLazy other) noexcept;
+    VECTORSTATS_CONSTEXPR ~VectorStatsLazy();
+
+    /**
+     * @brief Returns the owned E, allocating a default constructed one first if needed.
+     */
+    VECTORSTATS_CONSTEXPR E& get();
+
+    /**
+     * @brief Checks whether get() has allocated the owned E.
+     */
+    VECTORSTATS_CONSTEXPR explicit operator bool() const;
+
+    /**
+     * @brief Accesses the owned E. Only valid once it has been allocated.
+     */
+    VECTORSTATS_CONSTEXPR E& operator*();
+    VECTORSTATS_CONSTEXPR const E& operator*() const;
+    VECTORSTATS_CONSTEXPR E* operator->();
+    VECTORSTATS_CONSTEXPR const E* operator->() const;
+
+private:
+    E* _value;
+};
+
+
+////////////////////////////////////////
+// VectorStatsLazy Implementation
+////////////////////////////////////////
+
+template <typename E>
+VECTORSTATS_CONSTEXPR VectorStatsLazy<E>::VectorStatsLazy() : _value(nullptr) {}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR VectorStatsLazy<E>::VectorStatsLazy(const VectorStatsLazy& other)
+    : _value(other._value ? new E(*other._value) : nullptr) {}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR VectorStatsLazy<E>::VectorStatsLazy(VectorStatsLazy&& other) noexcept
+    : _value(other._value) {
+    other._value = nullptr;
+}
+
+// Taken by value, so one swap serves both copy and move assignment.
+template <typename E>
+VECTORSTATS_CONSTEXPR VectorStatsLazy<E>& VectorStatsLazy<E>::operator=(VectorStatsLazy other) noexcept {
+    std::swap(_value, other._value);
+    return *this;
+}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR VectorStatsLazy<E>::~VectorStatsLazy() {
+    delete _value;
+}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR E& VectorStatsLazy<E>::get() {
+    if (!_value) {
+        _value = new E();
+    }
+    return *_value;
+}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR VectorStatsLazy<E>::operator bool() const {
+    return _value != nullptr;
+}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR E& VectorStatsLazy<E>::operator*() {
+    return *_value;
+}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR const E& VectorStatsLazy<E>::operator*() const {
+    return *_value;
+}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR E* VectorStatsLazy<E>::operator->() {
+    return _value;
+}
+
+template <typename E>
+VECTORSTATS_CONSTEXPR const E* VectorStatsLazy<E>::operator->() const {
+    return _value;
+}
+
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * @file VectorStatsMedianHeap.h
+ * @brief This header file contains the indexed two-heap used by VectorStats for rolling medians.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_MEDIAN_HEAP_H
+#define VECTORSTATS_MEDIAN_HEAP_H
+
+#include <vector>
+#include <algorithm>
+#include "VectorStatsConfig.h"
+
+/**
+ * @class VectorStatsMedianHeap
+ * @brief Indexed two-heap that tracks the middle of a fixed-size buffer.
+ * - The low heap is a max-heap holding the smallest (size / 2) values.
+ * - The high heap is a min-heap holding the remaining values.
+ * - Every buffer slot knows where its value lives so it can be replaced in O(log n).
+ * @tparam T The data type of the buffer elements.
+ */
+template <typename T>
+class VectorStatsMedianHeap {
+public:
+    /**
+     * @brief Rebuilds both heaps from a buffer.
+     * @param data Pointer to the first buffer element.
+     * @param size Number of elements in the buffer.
+     */
+    VECTORSTATS_CONSTEXPR void build(const T* data, int size);
+
+    /**
+     * @brief Replaces the value held by a buffer slot and rebalances the heaps.
+     * @param slot Buffer index being overwritten.
+     * @param value New value of the slot.
+     */
+    VECTORSTATS_CONSTEXPR void replace(int slot, T value);
+
+    /**
+     * @brief Releases all memory held by the heaps.
+     */
+    VECTORSTATS_CONSTEXPR void clear();
+
+    /**
+     * @brief Gets the largest value of the low half.
+     * @return Element at sorted index (size / 2 - 1). Only valid for sizes >= 2.
+     */
+    VECTORSTATS_CONSTEXPR T leftMid() const;
+
+    /**
+     * @brief Gets the smallest value of the high half.
+     * @return Element at sorted index (size / 2).
+     */
+    VECTORSTATS_CONSTEXPR T rightMid() const;
+
+private:
+    struct Node {
+        T value;
+        int slot;
+    };
+
+    std::vector<Node> _low;   // Max-heap.
+    std::vector<Node> _high;  // Min-heap.
+    std::vector<int> _pos;    // Slot -> heap position. Low heap positions are stored as ~index.
+
+    VECTORSTATS_CONSTEXPR void _place(std::vector<Node>& heap, bool is_low, int index, const Node& node);
+    VECTORSTATS_CONSTEXPR void _siftUp(std::vector<Node>& heap, bool is_low, int index);
+    VECTORSTATS_CONSTEXPR void _siftDown(std::vector<Node>& heap, bool is_low, int index);
+    VECTORSTATS_CONSTEXPR static bool _before(bool is_low, const Node& a, const Node& b);
+};
+
+
+////////////////////////////////////////
+// VectorStatsMedianHeap Implementation
+////////////////////////////////////////
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsMedianHeap<T>::build(const T* data, int size) {
+    int mid = size / 2;
+    std::vector<Node> nodes(size);
+    for (int i = 0; i < size; ++i) {
+        nodes[i].value = data[i];
+        nodes[i].slot = i;
+    }
+    if (mid > 0) {
+        std::nth_element(nodes.begin(), nodes.begin() + mid, nodes.end(),
+            [](const Node& a, const Node& b) { return a.value < b.value; });
+    }
+
+    _low.assign(nodes.begin(), nodes.begin() + mid);
+    _high.assign(nodes.begin() + mid, nodes.end());
+    _pos.resize(size);
+    for (int i = 0; i < (int)_low.size(); ++i) _pos[_low[i].slot] = ~i;
+    for (int i = 0; i < (int)_high.size(); ++i) _pos[_high[i].slot] = i;
+
+    // Floyd heap construction keeps build at O(n).
+    for (int i = (int)_low.size() / 2 - 1; i >= 0; --i) _siftDown(_low, true, i);
+    for (int i = (int)_high.size() / 2 - 1; i >= 0; --i) _siftDown(_high, false, i);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsMedianHeap<T>::replace(int slot, T value) {
+    int pos = _pos[slot];
+    if (pos < 0) {
+        pos = ~pos;
+        _low[pos].value = value;
+        _siftUp(_low, true, pos);
+        _siftDown(_low, true, ~_pos[slot]);
+    } else {
+        _high[pos].value = value;
+        _siftUp(_high, false, pos);
+        _siftDown(_high, false, _pos[slot]);
+    }
+
+    // Only one value changed so a single exchange of the tops restores the split.
+    if (!_low.empty() && _high[0].value < _low[0].value) {
+        Node low_top = _low[0];
+        _place(_low, true, 0, _high[0]);
+        _place(_high, false, 0, low_top);
+        _siftDown(_low, true, 0);
+        _siftDown(_high, false, 0);
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsMedianHeap<T>::clear() {
+    std::vector<Node>().swap(_low);
+    std::vector<Node>().swap(_high);
+    std::vector<int>().swap(_pos);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsMedianHeap<T>::leftMid() const {
+    return _low[0].value;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsMedianHeap<T>::rightMid() const {
+    return _high[0].value;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsMedianHeap<T>::_place(std::vector<Node>& heap, bool is_low, int index, const Node& node) {
+    heap[index] = node;
+    _pos[node.slot] = is_low ? ~index : index;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR bool VectorStatsMedianHeap<T>::_before(bool is_low, const Node& a, const Node& b) {
+    return is_low ? (b.value < a.value) : (a.value < b.value);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsMedianHeap<T>::_siftUp(std::vector<Node>& heap, bool is_low, int index) {
+    Node node = heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!_before(is_low, node, heap[parent])) break;
+        _place(heap, is_low, index, heap[parent]);
+        index = parent;
+    }
+    _place(heap, is_low, index, node);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsMedianHeap<T>::_siftDown(std::vector<Node>& heap, bool is_low, int index) {
+    int size = heap.size();
+    Node node = heap[index];
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= size) break;
+        if (child + 1 < size && _before(is_low, heap[child + 1], heap[child])) child++;
+        if (!_before(is_low, heap[child], node)) break;
+        _place(heap, is_low, index, heap[child]);
+        index = child;
+    }
+    _place(heap, is_low, index, node);
+}
+
+
+#endif
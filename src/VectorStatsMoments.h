@@ -0,0 +1,222 @@
+/**
+ * @file VectorStatsMoments.h
+ * @brief This header file contains the mergeable moments exported by VectorStats.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_MOMENTS_H
+#define VECTORSTATS_MOMENTS_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "VectorStatsConfig.h"
+#include "VectorStatsKernels.h"
+
+/**
+ * @struct VectorStatsMoments
+ * @brief Compact statistics of a data set that can be merged with other data sets.
+ * - Holds count, mean, M2, min, max and the regression sums against x.
+ * - merge() uses the Chan et al. pairwise formulas, so merging is as precise as one pass over all data.
+ * - A default constructed object is empty and can be filled with add() or merge().
+ * - serialize() writes 64 bytes that deserialize() reads back on any host with 64 bit doubles.
+ */
+struct VectorStatsMoments {
+    uint64_t count = 0;  // Number of values.
+    double mean = 0;     // Mean of the values.
+    double m2 = 0;       // Sum of (value - mean)^2.
+    double min = 0;      // Smallest value.
+    double max = 0;      // Largest value.
+    double mean_x = 0;   // Mean of the x positions.
+    double m2_x = 0;     // Sum of (x - mean_x)^2.
+    double c_xy = 0;     // Sum of (x - mean_x)(value - mean).
+
+    static const int serialized_size = 64;
+
+    /**
+     * @brief Calculates moments of a block of data.
+     * @param data Pointer to the first value.
+     * @param size Number of values.
+     * @param x_start x position of the first value. Default = 1 like getSlope().
+     * - Give later blocks of the same stream a later x_start to merge them into one regression.
+     */
+    template <typename T>
+    static VECTORSTATS_CONSTEXPR VectorStatsMoments fromData(const T* data, int size, double x_start = 1);
+
+    /**
+     * @brief Adds one value at the next x position. Uses Welford's update.
+     */
+    VECTORSTATS_CONSTEXPR void add(double value);
+
+    /**
+     * @brief Combines another data set into this one.
+     */
+    VECTORSTATS_CONSTEXPR void merge(const VectorStatsMoments& other);
+
+    /**
+     * @brief Calculates the population variance.
+     */
+    VECTORSTATS_CONSTEXPR double getVariance() const;
+
+    /**
+     * @brief Calculates the population standard deviation.
+     */
+    VECTORSTATS_CONSTEXPR double getStdDev() const;
+
+    /**
+     * @brief Calculates slope of value against x using linear regression.
+     */
+    VECTORSTATS_CONSTEXPR double getSlope() const;
+
+    /**
+     * @brief Writes the moments as 64 little endian bytes.
+     * - The count is a uint64_t followed by the other 7 fields as IEEE 754 doubles.
+     * - Needs 64 bit doubles. 8 bit AVR boards cannot exchange moments with hosts.
+     * @param out Array of serialized_size bytes.
+     */
+    void serialize(uint8_t* out) const;
+
+    /**
+     * @brief Reads moments written by serialize().
+     * @param in Array of serialized_size bytes.
+     */
+    static VectorStatsMoments deserialize(const uint8_t* in);
+
+private:
+    static void _putBits(uint8_t* out, uint64_t bits);
+    static uint64_t _getBits(const uint8_t* in);
+    static uint64_t _doubleBits(double value);
+    static double _bitsDouble(uint64_t bits);
+};
+
+
+////////////////////////////////////////
+// VectorStatsMoments Implementation
+////////////////////////////////////////
+
+// x positions are consecutive so their mean and M2 are closed form.
+// Sum of (x - mean_x)(y - mean) reduces to sum(x y) - mean_x sum(y).
+template <typename T>
+VECTORSTATS_CONSTEXPR VectorStatsMoments VectorStatsMoments::fromData(const T* data, int size, double x_start) {
+    VectorStatsMoments moments = VectorStatsMoments();
+    if (size <= 0) {
+        return moments;
+    }
+    double total = VectorStatsKernels<T>::sum(data, size);
+    T low = data[0], high = data[0];
+    VectorStatsKernels<T>::minMax(data, size, low, high);
+
+    moments.count = size;
+    moments.mean = total / size;
+    moments.m2 = VectorStatsKernels<T>::sumSquaredDeviations(data, size, moments.mean);
+    moments.min = low;
+    moments.max = high;
+    moments.mean_x = x_start + (size - 1) / 2.0;
+    moments.m2_x = (double)size * ((double)size * size - 1) / 12.0;
+    moments.c_xy = VectorStatsKernels<T>::weightedSum(data, size) + (x_start - 1) * total - moments.mean_x * total;
+    return moments;
+}
+
+// Consecutive x positions end (count - 1) / 2 above mean_x, so the next one is (count + 1) / 2 above.
+VECTORSTATS_CONSTEXPR inline void VectorStatsMoments::add(double value) {
+    double x = count ? mean_x + (count + 1) / 2.0 : 1;
+    if (count == 0) {
+        min = value;
+        max = value;
+    }
+    count++;
+    double delta_x = x - mean_x;
+    double delta = value - mean;
+    mean_x += delta_x / count;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    m2_x += delta_x * (x - mean_x);
+    c_xy += delta_x * (value - mean);
+    if (value < min) min = value;
+    if (value > max) max = value;
+}
+
+VECTORSTATS_CONSTEXPR inline void VectorStatsMoments::merge(const VectorStatsMoments& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    double a_count = count, b_count = other.count;
+    double merged_count = a_count + b_count;
+    double weight = a_count * b_count / merged_count;
+    double delta = other.mean - mean;
+    double delta_x = other.mean_x - mean_x;
+
+    mean += delta * b_count / merged_count;
+    m2 += other.m2 + delta * delta * weight;
+    mean_x += delta_x * b_count / merged_count;
+    m2_x += other.m2_x + delta_x * delta_x * weight;
+    c_xy += other.c_xy + delta_x * delta * weight;
+    if (other.min < min) min = other.min;
+    if (other.max > max) max = other.max;
+    count += other.count;
+}
+
+VECTORSTATS_CONSTEXPR inline double VectorStatsMoments::getVariance() const {
+    return count ? m2 / count : 0;
+}
+
+VECTORSTATS_CONSTEXPR inline double VectorStatsMoments::getStdDev() const {
+    return std::sqrt(getVariance());
+}
+
+VECTORSTATS_CONSTEXPR inline double VectorStatsMoments::getSlope() const {
+    return m2_x > 0 ? c_xy / m2_x : 0;
+}
+
+inline void VectorStatsMoments::serialize(uint8_t* out) const {
+    const double fields[7] = {mean, m2, min, max, mean_x, m2_x, c_xy};
+    _putBits(out, count);
+    for (int i = 0; i < 7; ++i) {
+        _putBits(out + 8 * (i + 1), _doubleBits(fields[i]));
+    }
+}
+
+inline VectorStatsMoments VectorStatsMoments::deserialize(const uint8_t* in) {
+    VectorStatsMoments moments = VectorStatsMoments();
+    double* fields[7] = {&moments.mean, &moments.m2, &moments.min, &moments.max,
+                         &moments.mean_x, &moments.m2_x, &moments.c_xy};
+    moments.count = _getBits(in);
+    for (int i = 0; i < 7; ++i) {
+        *fields[i] = _bitsDouble(_getBits(in + 8 * (i + 1)));
+    }
+    return moments;
+}
+
+inline void VectorStatsMoments::_putBits(uint8_t* out, uint64_t bits) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = (uint8_t)(bits >> (8 * i));
+    }
+}
+
+inline uint64_t VectorStatsMoments::_getBits(const uint8_t* in) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        bits |= (uint64_t)in[i] << (8 * i);
+    }
+    return bits;
+}
+
+inline uint64_t VectorStatsMoments::_doubleBits(double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(value) < sizeof(bits) ? sizeof(value) : sizeof(bits));
+    return bits;
+}
+
+inline double VectorStatsMoments::_bitsDouble(uint64_t bits) {
+    double value = 0;
+    std::memcpy(&value, &bits, sizeof(value) < sizeof(bits) ? sizeof(value) : sizeof(bits));
+    return value;
+}
+
+
+#endif
@@ -0,0 +1,340 @@
+/**
+ * @file VectorStatsParallel.h
+ * @brief This header file contains the thread pool used by VectorStats for very large buffers.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_PARALLEL_H
+#define VECTORSTATS_PARALLEL_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "VectorStatsKernels.h"
+#include "VectorStatsMoments.h"
+#include "VectorStatsPolicy.h"
+
+/**
+ * @class VectorStatsParallel
+ * @brief Thread pool that splits a buffer into chunks and reduces them on every core.
+ * - Define VECTORSTATS_PARALLEL before including VectorStats.h and pass a pool to setParallel().
+ * - VectorStatsMoments of each chunk are combined with a pairwise merge so rounding error grows with log(chunks).
+ * - Buffers smaller than threshold() run serially on the calling thread.
+ * - Needs std::thread. Meant for hosts, not for 8 bit boards.
+ */
+class VectorStatsParallel {
+public:
+    /**
+     * @brief Constructor for VectorStatsParallel.
+     * @param threads Number of threads including the calling thread. Default = 0 for every hardware thread.
+     */
+    VectorStatsParallel(int threads = 0);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~VectorStatsParallel();
+
+    VectorStatsParallel(const VectorStatsParallel&) = delete;
+    VectorStatsParallel& operator=(const VectorStatsParallel&) = delete;
+
+    /**
+     * @brief Returns number of threads including the calling thread.
+     */
+    int threads() const;
+
+    /**
+     * @brief Sets the smallest buffer size that runs in parallel.
+     * @param threshold Buffer size in elements. Default = 262144.
+     */
+    void setThreshold(int threshold);
+
+    /**
+     * @brief Returns the smallest buffer size that runs in parallel.
+     */
+    int threshold() const;
+
+    /**
+     * @brief Sums a buffer in the accumulator of a VectorStats policy.
+     * - Every chunk is summed with Policy::sum and the chunk sums are combined with Policy::sum too,
+     *   so exact integer and compensated policies keep their precision.
+     * @tparam Policy Default = VectorStatsPolicy<> sums in double.
+     */
+    template <typename T, typename Policy = VectorStatsPolicy<>>
+    typename Policy::accumulator_type sum(const T* data, int size);
+
+    /**
+     * @brief Calculates the moments of a buffer with x positions from 1 to size.
+     * @return VectorStatsMoments merged from every chunk.
+     */
+    template <typename T>
+    VectorStatsMoments moments(const T* data, int size);
+
+    /**
+     * @brief Counts values below low or above high.
+     */
+    template <typename T>
+    int countOutside(const T* data, int size, double low, double high);
+
+    /**
+     * @brief Sums value * (index + 1) over a buffer.
+     */
+    template <typename T>
+    double weightedSum(const T* data, int size);
+
+    /**
+     * @brief Finds the center two values without reordering the buffer.
+     * - Sample pivots bracket the median, one parallel pass counts and copies the band
+     *   between them into scratch, and nth_element runs on the band only.
+     * @param scratch Reused memory for the band.
+     * @param left_mid Receives the element at sorted index (size / 2 - 1). Only set for sizes >= 2.
+     * @param right_mid Receives the element at sorted index (size / 2).
+     */
+    template <typename T>
+    void median(const T* data, int size, std::vector<T>& scratch, T& left_mid, T& right_mid);
+
+private:
+    static const int _samples = 4096;
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _finished;
+    std::function<void(int)> _job;
+    int _tasks;
+    std::atomic<int> _next_task;
+    int _busy;
+    unsigned _generation;
+    bool _stopping;
+    int _threshold;
+
+    void _run(int tasks, const std::function<void(int)>& job);
+    void _work();
+    void _workerLoop();
+    int _chunks(int size) const;
+};
+
+
+////////////////////////////////////////
+// VectorStatsParallel Implementation
+////////////////////////////////////////
+
+inline VectorStatsParallel::VectorStatsParallel(int threads)
+    : _tasks(0),
+      _next_task(0),
+      _busy(0),
+      _generation(0),
+      _stopping(false),
+      _threshold(262144) {
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 1; i < threads; ++i) {
+        _workers.emplace_back(&VectorStatsParallel::_workerLoop, this);
+    }
+}
+
+inline VectorStatsParallel::~VectorStatsParallel() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+inline int VectorStatsParallel::threads() const {
+    return (int)_workers.size() + 1;
+}
+
+inline void VectorStatsParallel::setThreshold(int threshold) {
+    _threshold = threshold;
+}
+
+inline int VectorStatsParallel::threshold() const {
+    return _threshold;
+}
+
+template <typename T, typename Policy>
+typename Policy::accumulator_type VectorStatsParallel::sum(const T* data, int size) {
+    typedef typename Policy::accumulator_type Accumulator;
+    int chunks = _chunks(size);
+    int chunk_size = (size + chunks - 1) / chunks;
+    std::vector<Accumulator> partials(chunks);
+    _run(chunks, [&](int chunk) {
+        int start = chunk * chunk_size;
+        partials[chunk] = Policy::sum(data + start, std::min(chunk_size, size - start));
+    });
+    return Policy::sum(partials.data(), chunks);
+}
+
+// Each chunk is summed around its own mean while it is still in cache, then merged pairwise.
+template <typename T>
+VectorStatsMoments VectorStatsParallel::moments(const T* data, int size) {
+    int chunks = _chunks(size);
+    int chunk_size = (size + chunks - 1) / chunks;
+    std::vector<VectorStatsMoments> partials(chunks);
+    _run(chunks, [&](int chunk) {
+        int start = chunk * chunk_size;
+        partials[chunk] = VectorStatsMoments::fromData(data + start, std::min(chunk_size, size - start), start + 1);
+    });
+    for (int step = 1; step < chunks; step *= 2) {
+        for (int i = 0; i + step < chunks; i += 2 * step) {
+            partials[i].merge(partials[i + step]);
+        }
+    }
+    return partials[0];
+}
+
+template <typename T>
+int VectorStatsParallel::countOutside(const T* data, int size, double low, double high) {
+    int chunks = _chunks(size);
+    int chunk_size = (size + chunks - 1) / chunks;
+    std::vector<int> partials(chunks);
+    _run(chunks, [&](int chunk) {
+        int start = chunk * chunk_size;
+        partials[chunk] = VectorStatsKernels<T>::countOutside(data + start, std::min(chunk_size, size - start), low, high);
+    });
+    int total = 0;
+    for (int partial : partials) total += partial;
+    return total;
+}
+
+// Chunks are weighted from 1 so every chunk adds start * sum for its offset.
+template <typename T>
+double VectorStatsParallel::weightedSum(const T* data, int size) {
+    int chunks = _chunks(size);
+    int chunk_size = (size + chunks - 1) / chunks;
+    std::vector<double> partials(chunks);
+    _run(chunks, [&](int chunk) {
+        int start = chunk * chunk_size;
+        int count = std::min(chunk_size, size - start);
+        partials[chunk] = VectorStatsKernels<T>::weightedSum(data + start, count) +
+            (double)start * VectorStatsKernels<T>::sum(data + start, count);
+    });
+    double total = 0.0;
+    for (double partial : partials) total += partial;
+    return total;
+}
+
+template <typename T>
+void VectorStatsParallel::median(const T* data, int size, std::vector<T>& scratch, T& left_mid, T& right_mid) {
+    int right_rank = size / 2;
+    int left_rank = size % 2 ? right_rank : right_rank - 1;
+
+    // Evenly spaced samples. The band keeps a margin of about 2 standard errors of the sample rank.
+    int samples = std::min(size, (int)_samples);
+    std::vector<T> sample(samples);
+    for (int i = 0; i < samples; ++i) {
+        sample[i] = data[(long long)i * size / samples];
+    }
+    std::sort(sample.begin(), sample.end());
+    int margin = 2 * (int)std::sqrt((double)samples) + 2;
+    T low = sample[std::max(0, (int)((long long)left_rank * samples / size) - margin)];
+    T high = sample[std::min(samples - 1, (int)((long long)right_rank * samples / size) + margin)];
+
+    int chunks = _chunks(size);
+    int chunk_size = (size + chunks - 1) / chunks;
+    std::vector<int> below(chunks), band(chunks);
+    _run(chunks, [&](int chunk) {
+        int start = chunk * chunk_size;
+        int end = std::min(size, start + chunk_size);
+        int below_count = 0, band_count = 0;
+        for (int i = start; i < end; ++i) {
+            below_count += data[i] < low;
+            band_count += !(data[i] < low) && !(high < data[i]);
+        }
+        below[chunk] = below_count;
+        band[chunk] = band_count;
+    });
+
+    int below_total = 0, band_total = 0;
+    std::vector<int> offsets(chunks);
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        below_total += below[chunk];
+        offsets[chunk] = band_total;
+        band_total += band[chunk];
+    }
+
+    // Unlucky samples missed a center rank, so select from a full copy instead.
+    if (below_total > left_rank || below_total + band_total <= right_rank) {
+        scratch.assign(data, data + size);
+        below_total = 0;
+    } else {
+        scratch.resize(band_total);
+        _run(chunks, [&](int chunk) {
+            int start = chunk * chunk_size;
+            int end = std::min(size, start + chunk_size);
+            T* out = scratch.data() + offsets[chunk];
+            for (int i = start; i < end; ++i) {
+                if (!(data[i] < low) && !(high < data[i])) *out++ = data[i];
+            }
+        });
+    }
+
+    int mid = right_rank - below_total;
+    std::nth_element(scratch.begin(), scratch.begin() + mid, scratch.end());
+    right_mid = scratch[mid];
+    if (mid > 0) {
+        left_mid = *std::max_element(scratch.begin(), scratch.begin() + mid);
+    }
+}
+
+// Runs job(0) to job(tasks - 1). The calling thread takes tasks too and returns when all are done.
+inline void VectorStatsParallel::_run(int tasks, const std::function<void(int)>& job) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = job;
+        _tasks = tasks;
+        _next_task.store(0);
+        _busy = (int)_workers.size();
+        _generation++;
+    }
+    _wake.notify_all();
+    _work();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.wait(lock, [this] { return _busy == 0; });
+}
+
+inline void VectorStatsParallel::_work() {
+    for (int task = _next_task.fetch_add(1); task < _tasks; task = _next_task.fetch_add(1)) {
+        _job(task);
+    }
+}
+
+inline void VectorStatsParallel::_workerLoop() {
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&] { return _stopping || _generation != seen; });
+            if (_stopping) return;
+            seen = _generation;
+        }
+        _work();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busy--;
+        }
+        _finished.notify_one();
+    }
+}
+
+// A few chunks per thread keep every thread busy when chunks finish unevenly.
+inline int VectorStatsParallel::_chunks(int size) const {
+    const int min_chunk = 16384;
+    return std::max(1, std::min(threads() * 4, size / min_chunk));
+}
+
+
+
+#endif
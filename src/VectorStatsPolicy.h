@@ -0,0 +1,114 @@
+/**
+ * @file VectorStatsPolicy.h
+ * @brief This header file contains the accumulator and result policies for VectorStats.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_POLICY_H
+#define VECTORSTATS_POLICY_H
+
+#include <type_traits>
+#include "VectorStatsConfig.h"
+#include "VectorStatsKernels.h"
+#include "VectorStatsInstrumentation.h"
+
+/**
+ * @struct VectorStatsPolicy
+ * @brief Chooses how VectorStats sums the buffer and what type its statistics return.
+ * - The default sums in double with the SIMD kernels and returns float, as VectorStats always has.
+ * - An integer accumulator sums integer data exactly and converts once at the end.
+ *   It must be wide enough for size * largest value, e.g. int32_t holds 65536 int16_t values.
+ * - A float accumulator is fastest on boards with a single precision FPU.
+ * - Result is returned by getAverage(), getStdDev(), getSlope() and the robust means.
+ * @tparam Accumulator Type that sums are kept in. Default = double.
+ * @tparam Result Type of the returned statistics. Default = float.
+ * @tparam Instrumentation Receives call counts and sort events. Default = VectorStatsNoInstrumentation compiles to nothing.
+ */
+template <typename Accumulator = double, typename Result = float, typename Instrumentation = VectorStatsNoInstrumentation>
+struct VectorStatsPolicy {
+    typedef Accumulator accumulator_type;
+    typedef Result result_type;
+    typedef Instrumentation instrumentation_type;
+
+    /**
+     * @brief Sums a range in the accumulator type.
+     */
+    template <typename T>
+    static VECTORSTATS_CONSTEXPR Accumulator sum(const T* data, int size) {
+        // The int16_t kernels already sum exactly in integer lanes.
+        if (std::is_same<Accumulator, double>::value ||
+            (std::is_integral<Accumulator>::value && std::is_same<T, int16_t>::value)) {
+            return (Accumulator)VectorStatsKernels<T>::sum(data, size);
+        }
+        Accumulator lane[4] = {0, 0, 0, 0};
+        int i = 0;
+        for (; i + 4 <= size; i += 4) {
+            lane[0] += data[i];
+            lane[1] += data[i + 1];
+            lane[2] += data[i + 2];
+            lane[3] += data[i + 3];
+        }
+        for (; i < size; ++i) lane[0] += data[i];
+        return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    }
+};
+
+/**
+ * @struct VectorStatsKahanPolicy
+ * @brief Sums floating point data with Neumaier compensated summation.
+ * - Rounding error stays near one ulp of the sum however long the buffer is.
+ * - About four times the work of the default sum.
+ * @tparam Result Type of the returned statistics. Default = float.
+ * @tparam Instrumentation Receives call counts and sort events. Default = VectorStatsNoInstrumentation.
+ */
+template <typename Result = float, typename Instrumentation = VectorStatsNoInstrumentation>
+struct VectorStatsKahanPolicy {
+    typedef double accumulator_type;
+    typedef Result result_type;
+    typedef Instrumentation instrumentation_type;
+
+    template <typename T>
+    static VECTORSTATS_CONSTEXPR double sum(const T* data, int size) {
+        double total = 0.0, compensation = 0.0;
+        for (int i = 0; i < size; ++i) {
+            double value = data[i];
+            double next = total + value;
+            // The smaller operand is the one that lost low bits.
+            if ((total < 0 ? -total : total) >= (value < 0 ? -value : value)) {
+                compensation += (total - next) + value;
+            } else {
+                compensation += (value - next) + total;
+            }
+            total = next;
+        }
+        return total + compensation;
+    }
+};
+
+/**
+ * @struct VectorStatsPairwisePolicy
+ * @brief Sums floating point data by splitting it in halves down to short blocks.
+ * - Rounding error grows with log(size) instead of size, at nearly the speed of the default sum.
+ * @tparam Result Type of the returned statistics. Default = float.
+ * @tparam Instrumentation Receives call counts and sort events. Default = VectorStatsNoInstrumentation.
+ */
+template <typename Result = float, typename Instrumentation = VectorStatsNoInstrumentation>
+struct VectorStatsPairwisePolicy {
+    typedef double accumulator_type;
+    typedef Result result_type;
+    typedef Instrumentation instrumentation_type;
+
+    template <typename T>
+    static VECTORSTATS_CONSTEXPR double sum(const T* data, int size) {
+        const int block = 128;
+        if (size <= block) {
+            return VectorStatsKernels<T>::sum(data, size);
+        }
+        int half = size / 2;
+        return sum(data, half) + sum(data + half, size - half);
+    }
+};
+
+
+#endif
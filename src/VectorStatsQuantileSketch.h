@@ -0,0 +1,273 @@
+/**
+ * @file VectorStatsQuantileSketch.h
+ * @brief This header file contains the mergeable streaming quantile sketch used by VectorStats.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_QUANTILE_SKETCH_H
+#define VECTORSTATS_QUANTILE_SKETCH_H
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include "VectorStatsConfig.h"
+
+/**
+ * @class VectorStatsQuantileSketch
+ * @brief KLL quantile sketch of every value ever added, in a few KB of memory.
+ * - Values pass through a stack of compactors. Level h values each stand for 2^h added values.
+ * - A full level is sorted and every other value moves up one level, starting at a random offset.
+ * - Lower levels hold k * (2/3)^depth values, so about 3k values are retained in total.
+ * - Rank error is about 1.7 / k of the stream length. k = 200 is within 1%.
+ * - add() is amortized O(log k). Two sketches of any size can be merged.
+ * - Each sketch draws its compaction coins from its own seed. Sketches fed in lockstep and merged
+ *   later would otherwise make the same keep or drop choices, which the error bound assumes they do not.
+ * @tparam T The data type of the values.
+ */
+template <typename T>
+class VectorStatsQuantileSketch {
+public:
+    /**
+     * @brief Constructor for VectorStatsQuantileSketch.
+     * @param k Size of the top level. Larger is more accurate and uses more memory. Default = 200.
+     * @param seed Seed of the compaction coins. Default = 0 gives every sketch a different seed.
+     * - The default seed is drawn from a shared counter at the first compaction, so constructing
+     *   a sketch, or keeping one that never fills, touches no shared state.
+     * - Pass the same non-zero seed to repeat a run exactly.
+     */
+    VECTORSTATS_CONSTEXPR VectorStatsQuantileSketch(int k = 200, uint32_t seed = 0);
+
+    /**
+     * @brief Adds one value to the sketch.
+     */
+    VECTORSTATS_CONSTEXPR void add(T value);
+
+    /**
+     * @brief Adds every value summarized by another sketch.
+     * - Both sketches should use the same k.
+     */
+    VECTORSTATS_CONSTEXPR void merge(const VectorStatsQuantileSketch& other);
+
+    /**
+     * @brief Estimates a quantile.
+     * @param quantile Fraction from 0.0 (smallest) to 1.0 (largest). 0.5 is the median.
+     * @return Estimated value as <initalized data type>. Returns -1 if the sketch is empty.
+     */
+    VECTORSTATS_CONSTEXPR T getQuantile(double quantile) const;
+
+    /**
+     * @brief Estimates the fraction of added values that are less than or equal to a value.
+     * @return Fraction from 0.0 to 1.0.
+     */
+    VECTORSTATS_CONSTEXPR double getRank(T value) const;
+
+    /**
+     * @brief Returns the number of values added, including merged sketches.
+     */
+    VECTORSTATS_CONSTEXPR uint64_t count() const;
+
+    /**
+     * @brief Returns the number of values currently held in memory.
+     */
+    VECTORSTATS_CONSTEXPR int retained() const;
+
+    /**
+     * @brief Empties the sketch and releases its memory.
+     */
+    VECTORSTATS_CONSTEXPR void clear();
+
+private:
+    struct Item {
+        T value;
+        uint64_t weight;
+    };
+
+    std::vector<std::vector<T>> _levels;
+    int _k;
+    int _retained;
+    int _max_retained;
+    uint64_t _count;
+    uint32_t _random;
+
+    static uint32_t _nextSeed();
+    VECTORSTATS_CONSTEXPR int _capacity(int level) const;
+    VECTORSTATS_CONSTEXPR void _grow();
+    VECTORSTATS_CONSTEXPR void _compress();
+    VECTORSTATS_CONSTEXPR std::vector<Item> _items() const;
+};
+
+
+////////////////////////////////////////
+// VectorStatsQuantileSketch Implementation
+////////////////////////////////////////
+
+template <typename T>
+VECTORSTATS_CONSTEXPR VectorStatsQuantileSketch<T>::VectorStatsQuantileSketch(int k, uint32_t seed)
+    : _k(k < 8 ? 8 : k),
+      _retained(0),
+      _max_retained(0),
+      _count(0),
+      _random(seed) {}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsQuantileSketch<T>::add(T value) {
+    if (_levels.empty()) {
+        _grow();
+    }
+    _levels[0].push_back(value);
+    _retained++;
+    _count++;
+    if (_retained >= _max_retained) {
+        _compress();
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsQuantileSketch<T>::merge(const VectorStatsQuantileSketch& other) {
+    while (_levels.size() < other._levels.size() || _levels.empty()) {
+        _grow();
+    }
+    for (size_t h = 0; h < other._levels.size(); ++h) {
+        _levels[h].insert(_levels[h].end(), other._levels[h].begin(), other._levels[h].end());
+    }
+    _retained += other._retained;
+    _count += other._count;
+    while (_retained >= _max_retained) {
+        _compress();
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsQuantileSketch<T>::getQuantile(double quantile) const {
+    if (_retained == 0) {
+        return -1;
+    }
+    std::vector<Item> items = _items();
+    uint64_t total = 0;
+    for (const Item& item : items) total += item.weight;
+
+    double target = quantile * total;
+    uint64_t cumulative = 0;
+    for (const Item& item : items) {
+        cumulative += item.weight;
+        if (cumulative > target) {
+            return item.value;
+        }
+    }
+    return items.back().value;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR double VectorStatsQuantileSketch<T>::getRank(T value) const {
+    uint64_t below = 0, total = 0;
+    for (size_t h = 0; h < _levels.size(); ++h) {
+        for (T item : _levels[h]) {
+            total += (uint64_t)1 << h;
+            if (!(value < item)) below += (uint64_t)1 << h;
+        }
+    }
+    return total ? (double)below / total : 0;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR uint64_t VectorStatsQuantileSketch<T>::count() const {
+    return _count;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR int VectorStatsQuantileSketch<T>::retained() const {
+    return _retained;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsQuantileSketch<T>::clear() {
+    std::vector<std::vector<T>>().swap(_levels);
+    _retained = 0;
+    _max_retained = 0;
+    _count = 0;
+}
+
+// Steps through the golden ratio sequence so consecutive sketches start far apart. Never 0, which xorshift cannot leave.
+template <typename T>
+uint32_t VectorStatsQuantileSketch<T>::_nextSeed() {
+    static std::atomic<uint32_t> instances(0);
+    uint32_t seed = (instances.fetch_add(1, std::memory_order_relaxed) + 1) * 0x9E3779B9u;
+    return seed ? seed : 0x9E3779B9u;
+}
+
+// The top level holds k values and each level below it holds 2/3 as many, never fewer than 2.
+template <typename T>
+VECTORSTATS_CONSTEXPR int VectorStatsQuantileSketch<T>::_capacity(int level) const {
+    double capacity = _k;
+    for (int depth = (int)_levels.size() - 1 - level; depth > 0; --depth) {
+        capacity *= 2.0 / 3.0;
+    }
+    int rounded = (int)capacity + ((int)capacity < capacity);
+    return rounded < 2 ? 2 : rounded;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsQuantileSketch<T>::_grow() {
+    _levels.emplace_back();
+    _max_retained = 0;
+    for (int h = 0; h < (int)_levels.size(); ++h) {
+        _max_retained += _capacity(h);
+    }
+    _levels.back().reserve(_capacity((int)_levels.size() - 1) + 1);
+}
+
+// Compacts the lowest full level, moving on up until the sketch fits again.
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsQuantileSketch<T>::_compress() {
+    for (int h = 0; h < (int)_levels.size(); ++h) {
+        if ((int)_levels[h].size() < _capacity(h)) {
+            continue;
+        }
+        if (h + 1 == (int)_levels.size()) {
+            _grow();
+        }
+
+        std::vector<T>& level = _levels[h];
+        std::vector<T>& next = _levels[h + 1];
+        T leftover = level.back();
+        bool odd = level.size() % 2;
+        if (odd) level.pop_back();
+        std::sort(level.begin(), level.end());
+
+        // xorshift32 picks whether the even or odd positions survive.
+        if (_random == 0) {
+            _random = VECTORSTATS_IS_CONSTANT_EVALUATED() ? 0x9E3779B9u : _nextSeed();
+        }
+        _random ^= _random << 13;
+        _random ^= _random >> 17;
+        _random ^= _random << 5;
+        for (size_t i = _random & 1; i < level.size(); i += 2) {
+            next.push_back(level[i]);
+        }
+        _retained -= (int)(level.size() / 2);
+        level.clear();
+        if (odd) level.push_back(leftover);
+
+        if (_retained < _max_retained) {
+            break;
+        }
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR std::vector<typename VectorStatsQuantileSketch<T>::Item> VectorStatsQuantileSketch<T>::_items() const {
+    std::vector<Item> items;
+    items.reserve(_retained);
+    for (size_t h = 0; h < _levels.size(); ++h) {
+        for (T value : _levels[h]) {
+            items.push_back(Item{value, (uint64_t)1 << h});
+        }
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.value < b.value; });
+    return items;
+}
+
+
+#endif
@@ -0,0 +1,275 @@
+/**
+ * @file VectorStatsRollup.h
+ * @brief This header file contains the multi-resolution rollup of summaries built on VectorStatsMoments.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_ROLLUP_H
+#define VECTORSTATS_ROLLUP_H
+
+#include <vector>
+#include <utility>
+#include "VectorStatsConfig.h"
+#include "VectorStatsMoments.h"
+#include "VectorStatsQuantileSketch.h"
+
+/**
+ * @class VectorStatsRollup
+ * @brief Summarizes a stream at several resolutions, e.g. seconds, minutes and hours, without keeping raw samples.
+ * - Level 0 buckets summarize fanout[0] samples. Level i buckets summarize fanout[i] completed level i - 1 buckets.
+ * - Every bucket is a VectorStatsMoments: count, mean, M2, min, max and the regression sums.
+ * - Each level keeps its newest history completed buckets in a ring. Older buckets live on only in coarser levels.
+ * - add() is O(1) amortized. A completed bucket is merged once into the open bucket of the next level.
+ * - x positions count samples from 1 across buckets, so merged slopes are per sample over the whole window.
+ * - setQuantileSketch(true) gives every bucket a mergeable KLL sketch as well.
+ * @tparam T The data type of the samples.
+ */
+template <typename T>
+class VectorStatsRollup {
+public:
+    /**
+     * @brief Constructor for VectorStatsRollup.
+     * @param fanouts Array of levels bucket sizes, finest first. Values below 1 are treated as 1.
+     * - {1000, 60, 60} at 1 kHz gives second, minute and hour buckets.
+     * @param levels Number of levels. At least 1.
+     * @param history Completed buckets kept per level. At least 1.
+     */
+    VectorStatsRollup(const int* fanouts, int levels, int history);
+
+    /**
+     * @brief Adds one sample to the open level 0 bucket and completes buckets that are full.
+     */
+    VECTORSTATS_CONSTEXPR void add(T value);
+
+    /**
+     * @brief Enables or disables a quantile sketch in every bucket.
+     * - Enabling clears the rollup. Each kept bucket holds up to about 3k values.
+     * @param enabled True to keep sketches.
+     * @param k Accuracy of every sketch. Default = 200.
+     */
+    void setQuantileSketch(bool enabled, int k = 200);
+
+    /**
+     * @brief Returns the number of levels.
+     */
+    VECTORSTATS_CONSTEXPR int levels() const;
+
+    /**
+     * @brief Returns the number of completed buckets currently kept in a level.
+     * @return 0 to history. Returns 0 if level is out of range.
+     */
+    VECTORSTATS_CONSTEXPR int buckets(int level) const;
+
+    /**
+     * @brief Returns the number of samples added since construction or clear().
+     */
+    VECTORSTATS_CONSTEXPR uint64_t count() const;
+
+    /**
+     * @brief Gets one completed bucket.
+     * @param level Level from 0 (finest) to levels() - 1.
+     * @param age 0 is the newest completed bucket.
+     * @return The bucket summary. Empty if level or age is out of range.
+     */
+    VECTORSTATS_CONSTEXPR VectorStatsMoments getBucket(int level, int age) const;
+
+    /**
+     * @brief Gets the bucket of a level that is still filling.
+     * @return The partial summary. Empty if level is out of range.
+     */
+    VECTORSTATS_CONSTEXPR VectorStatsMoments getOpen(int level) const;
+
+    /**
+     * @brief Merges the newest completed buckets of one level.
+     * - getWindow(1, 15) on second, minute, hour levels covers the last 15 complete minutes.
+     * @param buckets Number of buckets. Clamped to buckets(level).
+     * @return The merged summary. Empty if level is out of range.
+     */
+    VECTORSTATS_CONSTEXPR VectorStatsMoments getWindow(int level, int buckets) const;
+
+    /**
+     * @brief Estimates a quantile over the newest completed buckets of one level.
+     * - Needs setQuantileSketch(true).
+     * @param quantile Fraction from 0.0 (smallest) to 1.0 (largest).
+     * @return Estimated value as <initalized data type>. Returns -1 if sketches are off or the window is empty.
+     */
+    T getWindowQuantile(int level, int buckets, double quantile) const;
+
+    /**
+     * @brief Empties every level.
+     */
+    void clear();
+
+private:
+    struct Level {
+        int fanout;      // Children per bucket: samples at level 0, completed buckets above.
+        int children;    // Children merged into the open bucket so far.
+        int head;        // Ring slot the next completed bucket goes into.
+        int filled;      // Completed buckets in the ring.
+        VectorStatsMoments open;
+        std::vector<VectorStatsMoments> ring;
+        VectorStatsQuantileSketch<T> open_sketch;
+        std::vector<VectorStatsQuantileSketch<T>> sketches;
+    };
+
+    std::vector<Level> _levels;
+    int _history;
+    uint64_t _count;
+    bool _sketch_enabled;
+    int _sketch_k;
+
+    VECTORSTATS_CONSTEXPR void _complete(int level);
+    VECTORSTATS_CONSTEXPR int _slot(int level, int age) const;
+};
+
+
+////////////////////////////////////////
+// VectorStatsRollup Implementation
+////////////////////////////////////////
+
+template <typename T>
+VectorStatsRollup<T>::VectorStatsRollup(const int* fanouts, int levels, int history)
+    : _history(history < 1 ? 1 : history),
+      _count(0),
+      _sketch_enabled(false),
+      _sketch_k(200) {
+    _levels.resize(levels < 1 ? 1 : levels);
+    for (size_t i = 0; i < _levels.size(); ++i) {
+        _levels[i].fanout = (int)i < levels && fanouts[i] > 1 ? fanouts[i] : 1;
+        _levels[i].ring.resize(_history);
+    }
+    clear();
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsRollup<T>::add(T value) {
+    Level& first = _levels[0];
+    bool starting = first.open.count == 0;
+    first.open.add(value);
+    // add() numbers a fresh bucket from x = 1. Moving it to the stream position keeps merged slopes continuous.
+    if (starting) {
+        first.open.mean_x = (double)_count + 1;
+    }
+    if (_sketch_enabled) {
+        first.open_sketch.add(value);
+    }
+    _count++;
+    if (++first.children >= first.fanout) {
+        _complete(0);
+    }
+}
+
+template <typename T>
+void VectorStatsRollup<T>::setQuantileSketch(bool enabled, int k) {
+    _sketch_enabled = enabled;
+    _sketch_k = k;
+    for (size_t i = 0; i < _levels.size(); ++i) {
+        // Copies are fine: each sketch draws its own seed at its first compaction.
+        _levels[i].sketches.assign(enabled ? _history : 0, VectorStatsQuantileSketch<T>(k));
+    }
+    clear();
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR int VectorStatsRollup<T>::levels() const {
+    return (int)_levels.size();
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR int VectorStatsRollup<T>::buckets(int level) const {
+    return level >= 0 && level < levels() ? _levels[level].filled : 0;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR uint64_t VectorStatsRollup<T>::count() const {
+    return _count;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR VectorStatsMoments VectorStatsRollup<T>::getBucket(int level, int age) const {
+    if (age < 0 || age >= buckets(level)) {
+        return VectorStatsMoments();
+    }
+    return _levels[level].ring[_slot(level, age)];
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR VectorStatsMoments VectorStatsRollup<T>::getOpen(int level) const {
+    return level >= 0 && level < levels() ? _levels[level].open : VectorStatsMoments();
+}
+
+// Merged oldest first so the result matches one pass over the samples in order.
+template <typename T>
+VECTORSTATS_CONSTEXPR VectorStatsMoments VectorStatsRollup<T>::getWindow(int level, int buckets) const {
+    VectorStatsMoments window = VectorStatsMoments();
+    int available = this->buckets(level);
+    for (int age = (buckets < available ? buckets : available) - 1; age >= 0; --age) {
+        window.merge(_levels[level].ring[_slot(level, age)]);
+    }
+    return window;
+}
+
+template <typename T>
+T VectorStatsRollup<T>::getWindowQuantile(int level, int buckets, double quantile) const {
+    if (!_sketch_enabled) {
+        return -1;
+    }
+    VectorStatsQuantileSketch<T> window(_sketch_k);
+    int available = this->buckets(level);
+    for (int age = 0; age < buckets && age < available; ++age) {
+        window.merge(_levels[level].sketches[_slot(level, age)]);
+    }
+    return window.getQuantile(quantile);
+}
+
+template <typename T>
+void VectorStatsRollup<T>::clear() {
+    _count = 0;
+    for (size_t i = 0; i < _levels.size(); ++i) {
+        Level& level = _levels[i];
+        level.children = 0;
+        level.head = 0;
+        level.filled = 0;
+        level.open = VectorStatsMoments();
+        level.open_sketch = VectorStatsQuantileSketch<T>(_sketch_k);
+        for (size_t j = 0; j < level.sketches.size(); ++j) {
+            level.sketches[j].clear();
+        }
+    }
+}
+
+// Pushes the open bucket into the ring and hands it up, cascading while parents fill.
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsRollup<T>::_complete(int level) {
+    Level& current = _levels[level];
+    Level* parent = level + 1 < levels() ? &_levels[level + 1] : nullptr;
+    if (parent) {
+        parent->open.merge(current.open);
+    }
+    current.ring[current.head] = current.open;
+    current.open = VectorStatsMoments();
+    if (_sketch_enabled) {
+        if (parent) {
+            parent->open_sketch.merge(current.open_sketch);
+        }
+        std::swap(current.sketches[current.head], current.open_sketch);
+        current.open_sketch.clear();
+    }
+    current.head = (current.head + 1) % _history;
+    if (current.filled < _history) {
+        current.filled++;
+    }
+    current.children = 0;
+    if (parent && ++parent->children >= parent->fanout) {
+        _complete(level + 1);
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR int VectorStatsRollup<T>::_slot(int level, int age) const {
+    return (_levels[level].head - 1 - age + _history) % _history;
+}
+
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file VectorStatsSPSC.h
+ * @brief This header file contains declarations for the VectorStatsSPSC class.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_SPSC_H
+#define VECTORSTATS_SPSC_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "VectorStats.h"
+
+/**
+ * @class VectorStatsSPSC
+ * @brief Lock-free ingestion ring for one producer thread and one consumer thread.
+ * - The producer calls add() and never blocks or waits. The oldest samples are overwritten.
+ * - The consumer calls snapshot() to copy the newest window, oldest first, then runs statistics on the copy.
+ * - The ring holds window_size + slack samples. The slack is how far the producer may run ahead
+ *   while a snapshot is being copied before that snapshot has to be retried.
+ * - The ring is rounded up to a power of two so slots stay in step when the 32 bit sequence counters wrap.
+ * - Requires std::atomic<T>. Meant for hosts with threads, not for 8 bit boards.
+ * @tparam T The data type of the samples.
+ */
+template <typename T>
+class VectorStatsSPSC {
+public:
+    /**
+     * @brief Constructor for VectorStatsSPSC.
+     * @param window_size Number of samples returned by every snapshot.
+     * @param slack Extra ring slots for the producer to write into during a snapshot. Default = -1 for window_size.
+     * - 0 adds no slack beyond rounding the ring up to a power of two. Every add() that lands on the window
+     *   during a snapshot then forces a retry. Values below -1 are treated as 0.
+     */
+    VectorStatsSPSC(int window_size, int slack = -1);
+
+    /**
+     * @brief Producer only. Adds a sample replacing the oldest sample.
+     */
+    void add(T value);
+
+    /**
+     * @brief Returns the number of samples in every snapshot.
+     */
+    int windowSize() const;
+
+    /**
+     * @brief Checks if at least one full window has been added.
+     */
+    bool windowFull() const;
+
+    /**
+     * @brief Consumer only. Copies the newest window of samples, oldest first.
+     * @param out Array of windowSize() elements.
+     * @return true on success. false if a full window has not been added yet,
+     *   or if the producer kept overwriting the window for every retry.
+     */
+    bool snapshot(T* out);
+
+    /**
+     * @brief Consumer only. Loads the newest window into a VectorStats buffer, oldest at element 0.
+     * - The buffer size must equal windowSize().
+     * @return true on success. The buffer is unchanged on failure.
+     */
+    template <int N, typename Policy>
+    bool snapshot(VectorStats<T, N, Policy>& stats);
+
+private:
+    static const int _max_retries = 8;
+
+    const int _window_size;
+    const uint32_t _capacity;  // Power of two.
+    const uint32_t _mask;      // _capacity - 1.
+    std::vector<std::atomic<T>> _ring;
+    std::vector<T> _scratch;  // Consumer side copy for snapshot(VectorStats&).
+
+    // Kept on separate cache lines so producer and consumer do not share a line.
+    // Both counters wrap. Only differences between them are used, which stay correct across the wrap.
+    alignas(64) std::atomic<uint32_t> _claimed;    // Samples the producer has started writing.
+    alignas(64) std::atomic<uint32_t> _published;  // Samples the producer has finished writing.
+    int _produced;                                 // Producer only. Counts up to _window_size, then stops.
+    std::atomic<bool> _filled;                     // Set once the first window is published.
+
+    static uint32_t _roundUp(uint32_t size);
+};
+
+
+////////////////////////////////////////
+// VectorStatsSPSC Class Implementation
+////////////////////////////////////////
+
+template <typename T>
+VectorStatsSPSC<T>::VectorStatsSPSC(int window_size, int slack)
+    : _window_size(window_size),
+      _capacity(_roundUp(window_size + (slack == -1 ? window_size : (slack > 0 ? slack : 0)))),
+      _mask(_capacity - 1),
+      _ring(_capacity),  // Preallocates memory.
+      _claimed(0),
+      _published(0),
+      _produced(0),
+      _filled(false) {}
+
+// Sequence lock ordering. The claim is visible before the slot is overwritten
+// and the slot is visible before the sample is published.
+template <typename T>
+void VectorStatsSPSC<T>::add(T value) {
+    uint32_t head = _published.load(std::memory_order_relaxed);
+    _claimed.store(head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _ring[head & _mask].store(value, std::memory_order_relaxed);
+    _published.store(head + 1, std::memory_order_release);
+    if (_produced < _window_size && ++_produced == _window_size) {
+        _filled.store(true, std::memory_order_release);
+    }
+}
+
+template <typename T>
+int VectorStatsSPSC<T>::windowSize() const {
+    return _window_size;
+}
+
+template <typename T>
+bool VectorStatsSPSC<T>::windowFull() const {
+    return _filled.load(std::memory_order_acquire);
+}
+
+// Copies, then checks that no slot of the copied window was claimed for overwriting meanwhile.
+template <typename T>
+bool VectorStatsSPSC<T>::snapshot(T* out) {
+    if (!_filled.load(std::memory_order_acquire)) {
+        return false;
+    }
+    for (int attempt = 0; attempt < _max_retries; ++attempt) {
+        uint32_t head = _published.load(std::memory_order_acquire);
+        uint32_t start = head - _window_size;
+        for (int i = 0; i < _window_size; ++i) {
+            out[i] = _ring[(start + i) & _mask].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t claimed = _claimed.load(std::memory_order_relaxed);
+        if (claimed - start <= _capacity) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+template <int N, typename Policy>
+bool VectorStatsSPSC<T>::snapshot(VectorStats<T, N, Policy>& stats) {
+    if (stats.size() != _window_size) {
+        return false;
+    }
+    _scratch.resize(_window_size);
+    if (!snapshot(_scratch.data())) {
+        return false;
+    }
+    stats.zeroBuffer();
+    stats.addBatch(_scratch.data(), _scratch.size());
+    return true;
+}
+
+template <typename T>
+uint32_t VectorStatsSPSC<T>::_roundUp(uint32_t size) {
+    uint32_t capacity = 1;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * @file VectorStatsSortedShadow.h
+ * @brief This header file contains the sorted copy used by VectorStats to answer ranks without re-sorting.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_SORTED_SHADOW_H
+#define VECTORSTATS_SORTED_SHADOW_H
+
+#include <vector>
+#include <algorithm>
+#include "VectorStatsConfig.h"
+
+/**
+ * @class VectorStatsSortedShadow
+ * @brief Sorted copy of a buffer that absorbs replacements instead of being sorted again.
+ * - replace() only queues the old and new value, so add() stays O(1).
+ * - flush() applies the queue before ranks are read. A few replacements are moved into place one
+ *   at a time with binary search and a shift. Longer queues are sorted and merged in one O(n + k log k) pass.
+ * - A queue as long as the buffer is dropped and the copy is sorted again.
+ * @tparam T The data type of the buffer elements.
+ */
+template <typename T>
+class VectorStatsSortedShadow {
+public:
+    /**
+     * @brief Sorts a copy of a buffer.
+     * @param data Pointer to the first buffer element.
+     * @param size Number of elements in the buffer.
+     */
+    VECTORSTATS_CONSTEXPR void build(const T* data, int size);
+
+    /**
+     * @brief Queues the replacement of one buffer value.
+     */
+    VECTORSTATS_CONSTEXPR void replace(T old_value, T new_value);
+
+    /**
+     * @brief Applies every queued replacement.
+     * @param data The buffer the copy was built from, used only when the queue grew too long.
+     */
+    VECTORSTATS_CONSTEXPR void flush(const T* data);
+
+    /**
+     * @brief Finds the value at a sorted index. Call flush() first.
+     * @param rank Sorted index from 0 to size - 1.
+     */
+    VECTORSTATS_CONSTEXPR T rank(int rank) const;
+
+    /**
+     * @brief Returns the number of queued replacements.
+     */
+    VECTORSTATS_CONSTEXPR int pending() const;
+
+    /**
+     * @brief Releases all memory held by the copy.
+     */
+    VECTORSTATS_CONSTEXPR void clear();
+
+private:
+    // Below this many replacements, shifting each into place beats a merge pass.
+    static const int _shift_limit = 8;
+
+    std::vector<T> _sorted;
+    std::vector<T> _removed;  // Queued old values.
+    std::vector<T> _added;    // Queued new values.
+    std::vector<T> _merged;   // Merge scratch, reused between flushes.
+    bool _stale = false;
+
+    VECTORSTATS_CONSTEXPR void _shift(T old_value, T new_value);
+    VECTORSTATS_CONSTEXPR void _merge();
+};
+
+
+////////////////////////////////////////
+// VectorStatsSortedShadow Implementation
+////////////////////////////////////////
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSortedShadow<T>::build(const T* data, int size) {
+    _sorted.assign(data, data + size);
+    std::sort(_sorted.begin(), _sorted.end());
+    _removed.clear();
+    _added.clear();
+    _stale = false;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSortedShadow<T>::replace(T old_value, T new_value) {
+    if (_stale) {
+        return;
+    }
+    if (_removed.size() >= _sorted.size()) {
+        _removed.clear();
+        _added.clear();
+        _stale = true;
+        return;
+    }
+    _removed.push_back(old_value);
+    _added.push_back(new_value);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSortedShadow<T>::flush(const T* data) {
+    if (_stale) {
+        build(data, (int)_sorted.size());
+        return;
+    }
+    if ((int)_removed.size() <= _shift_limit) {
+        for (size_t i = 0; i < _removed.size(); ++i) {
+            _shift(_removed[i], _added[i]);
+        }
+    } else {
+        _merge();
+    }
+    _removed.clear();
+    _added.clear();
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR T VectorStatsSortedShadow<T>::rank(int rank) const {
+    return _sorted[rank];
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR int VectorStatsSortedShadow<T>::pending() const {
+    return (int)_removed.size();
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSortedShadow<T>::clear() {
+    std::vector<T>().swap(_sorted);
+    std::vector<T>().swap(_removed);
+    std::vector<T>().swap(_added);
+    std::vector<T>().swap(_merged);
+    _stale = false;
+}
+
+// Only the values between the old and new positions move, one step toward the gap.
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSortedShadow<T>::_shift(T old_value, T new_value) {
+    typename std::vector<T>::iterator old_position = std::lower_bound(_sorted.begin(), _sorted.end(), old_value);
+    if (old_value < new_value) {
+        typename std::vector<T>::iterator new_position = std::lower_bound(old_position, _sorted.end(), new_value);
+        std::copy(old_position + 1, new_position, old_position);
+        *(new_position - 1) = new_value;
+    } else {
+        typename std::vector<T>::iterator new_position = std::upper_bound(_sorted.begin(), old_position, new_value);
+        std::copy_backward(new_position, old_position, old_position + 1);
+        *new_position = new_value;
+    }
+}
+
+// The copy becomes sorted - removed + added. A value added and removed within the same queue cancels
+// first, so every value left in removed is in the copy.
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSortedShadow<T>::_merge() {
+    std::sort(_removed.begin(), _removed.end());
+    std::sort(_added.begin(), _added.end());
+    size_t kept_removed = 0, kept_added = 0;
+    for (size_t r = 0, a = 0; r < _removed.size() || a < _added.size();) {
+        if (a == _added.size() || (r < _removed.size() && _removed[r] < _added[a])) {
+            _removed[kept_removed++] = _removed[r++];
+        } else if (r == _removed.size() || _added[a] < _removed[r]) {
+            _added[kept_added++] = _added[a++];
+        } else {
+            r++;
+            a++;
+        }
+    }
+    _removed.resize(kept_removed);
+    _added.resize(kept_added);
+
+    _merged.resize(_sorted.size());
+    size_t out = 0, r = 0, a = 0;
+    for (size_t s = 0; s < _sorted.size(); ++s) {
+        if (r < _removed.size() && !(_removed[r] < _sorted[s]) && !(_sorted[s] < _removed[r])) {
+            r++;
+            continue;
+        }
+        while (a < _added.size() && _added[a] < _sorted[s]) {
+            _merged[out++] = _added[a++];
+        }
+        _merged[out++] = _sorted[s];
+    }
+    while (a < _added.size()) {
+        _merged[out++] = _added[a++];
+    }
+    _sorted.swap(_merged);
+}
+
+
+#endif
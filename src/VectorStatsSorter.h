@@ -0,0 +1,155 @@
+/**
+ * @file VectorStatsSorter.h
+ * @brief This header file contains the sort engine used by VectorStats for full sorts.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_SORTER_H
+#define VECTORSTATS_SORTER_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include "VectorStatsConfig.h"
+#include "VectorStatsKernels.h"
+
+/**
+ * @class VectorStatsSorter
+ * @brief Sorts a buffer in O(n) for 8, 16 and 32 bit integers and with std::sort for everything else.
+ * - A value range no wider than the buffer is counted into bins and written back in order.
+ * - Otherwise an LSD radix sort makes one stable pass per byte, two for 16 bit values.
+ *   Bytes that are the same in every value are skipped.
+ * - Floating point, 64 bit and buffers under 256 elements use std::sort, as do 32 bit buffers
+ *   under 2048 elements with a wide range.
+ * - Scratch memory is kept between sorts so repeated sorts do not allocate.
+ * @tparam T The data type of the buffer elements.
+ */
+template <typename T>
+class VectorStatsSorter {
+public:
+    /**
+     * @brief Sorts data from smallest to largest.
+     */
+    VECTORSTATS_CONSTEXPR void sort(T* data, int size);
+
+    /**
+     * @brief Releases the scratch memory.
+     */
+    VECTORSTATS_CONSTEXPR void clear();
+
+    /**
+     * @brief Checks whether sorting size elements takes the counting or radix sort, which uses scratch memory.
+     * - Smaller sizes and other types are sorted in place by std::sort.
+     */
+    static VECTORSTATS_CONSTEXPR bool usesScratch(int size);
+
+private:
+    static const int _min_size = 256;         // std::sort wins below this.
+    static const int _min_radix_size = 2048;  // Four radix passes over 32 bit values need more to pay off.
+    static const bool _integer = std::is_integral<T>::value && sizeof(T) <= 4;
+
+    typedef typename std::make_unsigned<typename std::conditional<_integer, T, int>::type>::type Key;
+
+    std::vector<T> _scratch;
+    std::vector<uint32_t> _counts;
+
+    // Flipping the sign bit makes signed values sort correctly as unsigned keys.
+    static VECTORSTATS_CONSTEXPR Key _key(T value) {
+        return std::is_signed<T>::value ? (Key)((Key)value ^ ((Key)1 << (sizeof(Key) * 8 - 1))) : (Key)value;
+    }
+
+    VECTORSTATS_CONSTEXPR void _counting(T* data, int size, T low, uint32_t range);
+    VECTORSTATS_CONSTEXPR void _radix(T* data, int size);
+};
+
+
+////////////////////////////////////////
+// VectorStatsSorter Implementation
+////////////////////////////////////////
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSorter<T>::sort(T* data, int size) {
+    if (!usesScratch(size)) {
+        std::sort(data, data + size);
+        return;
+    }
+    T low = data[0], high = data[0];
+    VectorStatsKernels<T>::minMax(data, size, low, high);
+    uint32_t range = (uint32_t)(_key(high) - _key(low)) + 1;
+    if (range != 0 && range <= (uint32_t)size) {
+        _counting(data, size, low, range);
+    } else if (sizeof(T) > 2 && size < _min_radix_size) {
+        std::sort(data, data + size);
+    } else {
+        _radix(data, size);
+    }
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSorter<T>::clear() {
+    std::vector<T>().swap(_scratch);
+    std::vector<uint32_t>().swap(_counts);
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR bool VectorStatsSorter<T>::usesScratch(int size) {
+    return _integer && size >= _min_size;
+}
+
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSorter<T>::_counting(T* data, int size, T low, uint32_t range) {
+    _counts.assign(range, 0);
+    Key base = _key(low);
+    for (int i = 0; i < size; ++i) {
+        _counts[(Key)(_key(data[i]) - base)]++;
+    }
+    int out = 0;
+    for (uint32_t bin = 0; bin < range; ++bin) {
+        T value = (T)(low + (T)bin);
+        for (uint32_t count = _counts[bin]; count > 0; --count) {
+            data[out++] = value;
+        }
+    }
+}
+
+// All byte histograms are counted in one read, then each needed pass scatters into the other array.
+template <typename T>
+VECTORSTATS_CONSTEXPR void VectorStatsSorter<T>::_radix(T* data, int size) {
+    const int passes = sizeof(T);
+    _counts.assign(256 * passes, 0);
+    for (int i = 0; i < size; ++i) {
+        Key key = _key(data[i]);
+        for (int pass = 0; pass < passes; ++pass) {
+            _counts[256 * pass + ((key >> (8 * pass)) & 0xFF)]++;
+        }
+    }
+
+    _scratch.resize(size);
+    T* from = data;
+    T* to = _scratch.data();
+    for (int pass = 0; pass < passes; ++pass) {
+        uint32_t* counts = _counts.data() + 256 * pass;
+        if (counts[(_key(from[0]) >> (8 * pass)) & 0xFF] == (uint32_t)size) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (int bin = 0; bin < 256; ++bin) {
+            uint32_t count = counts[bin];
+            counts[bin] = offset;
+            offset += count;
+        }
+        for (int i = 0; i < size; ++i) {
+            T value = from[i];
+            to[counts[(_key(value) >> (8 * pass)) & 0xFF]++] = value;
+        }
+        std::swap(from, to);
+    }
+    if (from != data) {
+        std::copy(from, from + size, data);
+    }
+}
+
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * @file VectorStatsStorage.h
+ * @brief This header file contains the buffer storage used by VectorStats.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_STORAGE_H
+#define VECTORSTATS_STORAGE_H
+
+#include <vector>
+#include <array>
+#include "VectorStatsConfig.h"
+
+/**
+ * @class VectorStatsStorage
+ * @brief Fixed-capacity storage backed by std::array.
+ * - Size, midpoint and parity are compile-time constants.
+ * - Never allocates.
+ * @tparam T The data type of the buffer elements.
+ * @tparam N The number of buffer elements.
+ */
+template <typename T, int N>
+class VectorStatsStorage {
+    static_assert(N > 0, "VectorStats buffer size must be positive.");
+
+protected:
+    VECTORSTATS_CONSTEXPR VectorStatsStorage() : _data_array() {}
+
+    // Only the compile-time size is accepted.
+    VECTORSTATS_CONSTEXPR bool _resizeStorage(int buffer_size) {
+        return buffer_size == N;
+    }
+
+    std::array<T, N> _data_array;
+    static constexpr int _max_buffer_size = N;
+    static constexpr int _size = N;
+    static constexpr int _mid_element = N / 2;
+    static constexpr bool _odd_parity = N % 2;
+};
+
+template <typename T, int N> constexpr int VectorStatsStorage<T, N>::_max_buffer_size;
+template <typename T, int N> constexpr int VectorStatsStorage<T, N>::_size;
+template <typename T, int N> constexpr int VectorStatsStorage<T, N>::_mid_element;
+template <typename T, int N> constexpr bool VectorStatsStorage<T, N>::_odd_parity;
+
+/**
+ * @class VectorStatsStorage
+ * @brief Runtime-sized storage backed by a preallocated std::vector.
+ * @tparam T The data type of the buffer elements.
+ */
+template <typename T>
+class VectorStatsStorage<T, 0> {
+protected:
+    VECTORSTATS_CONSTEXPR VectorStatsStorage(int max_buffer_size)
+        : _data_array(max_buffer_size),  // Preallocates memory.
+          _max_buffer_size(max_buffer_size),
+          _size(max_buffer_size),
+          _mid_element(max_buffer_size / 2),
+          _odd_parity(max_buffer_size % 2) {}
+
+    // Resizes buffer to any size up to max_buffer_size.
+    // Max size of vector must be preallocated on microcontrollers.
+    VECTORSTATS_CONSTEXPR bool _resizeStorage(int buffer_size) {
+        if (buffer_size > _max_buffer_size) {
+            return false;
+        }
+        _size = buffer_size;
+        _mid_element = buffer_size / 2;
+        _odd_parity = buffer_size % 2;
+        _data_array.resize(buffer_size);
+        return true;
+    }
+
+    std::vector<T> _data_array;
+    const int _max_buffer_size;
+    int _size;
+    int _mid_element;
+    bool _odd_parity;
+};
+
+
+#endif
@@ -0,0 +1,385 @@
+/**
+ * @file VectorStatsView.h
+ * @brief This header file contains declarations for the VectorStatsView class.
+ * @author Steve Hambling
+ * @date 2026-10-16
+ */
+
+#ifndef VECTORSTATS_VIEW_H
+#define VECTORSTATS_VIEW_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include "VectorStats.h"
+
+/**
+ * @class VectorStatsView
+ * @brief Runs the VectorStats statistics on memory owned by someone else.
+ * - Nothing is copied for average, standard deviation, outliers, skew, slope or summary.
+ * - The data can be one block or a wrapped ring given as two blocks, oldest block first.
+ * - getMedian() and getSortedElement() work on an internal scratch copy so the caller's memory is never modified.
+ * - Sums go through the same Policy as VectorStats, so an exact integer or Kahan policy gives the same results.
+ * - An empty view returns 0 for every statistic and -1 for median and elements.
+ * - getSlope() is NaN for fewer than 2 elements, the same as VectorStats::getSlope() on a 1 element buffer.
+ * @tparam T The data type of the viewed elements.
+ * @tparam Policy Accumulator and result types. Default = VectorStatsPolicy<> sums in double and returns float.
+ */
+template <typename T, typename Policy = VectorStatsPolicy<>>
+class VectorStatsView {
+public:
+    typedef typename Policy::accumulator_type Accumulator;
+    typedef typename Policy::result_type Result;
+
+    /**
+     * @brief Constructor for a single block of memory.
+     * @param data Pointer to the first element.
+     * @param size Number of elements.
+     */
+    VectorStatsView(const T* data, int size);
+
+    /**
+     * @brief Constructor for a wrapped ring given as two blocks.
+     * @param first Pointer to the oldest block.
+     * @param first_size Number of elements in the oldest block.
+     * @param second Pointer to the newest block.
+     * @param second_size Number of elements in the newest block.
+     */
+    VectorStatsView(const T* first, int first_size, const T* second, int second_size);
+
+    /**
+     * @brief Points the view at a new single block of memory.
+     * - Also call after the viewed memory changes to drop the sorted scratch copy.
+     */
+    void setData(const T* data, int size);
+
+    /**
+     * @brief Points the view at a new wrapped ring given as two blocks.
+     * - Also call after the viewed memory changes to drop the sorted scratch copy.
+     */
+    void setData(const T* first, int first_size, const T* second, int second_size);
+
+    /**
+     * @brief Returns number of viewed elements.
+     */
+    int size() const;
+
+    /**
+     * @brief Calculates median of viewed data.
+     * - Copies the data into scratch memory. The viewed memory is not changed.
+     * @return Median as <initalized data type>
+     * - Returns rounded average of center two numbers for even sizes. Returns -1 if the view is empty.
+     */
+    T getMedian();
+
+    /**
+     * @brief Calculates the average of viewed data.
+     * @return Average as the policy Result type, float by default.
+     */
+    Result getAverage() const;
+
+    /**
+     * @brief Calculates the population standard deviation of viewed data.
+     * @return Standard Deviation as the policy Result type, float by default.
+     */
+    Result getStdDev() const;
+
+    /**
+     * @brief Gets element in viewed order.
+     * @param element An integer representing the index value. 0 is the oldest element.
+     * @return Element as <initalized data type>
+     * - Returns -1 if element is out of range.
+     */
+    T getElement(int element) const;
+
+    /**
+     * @brief Gets element in sorted order from smallest to largest.
+     * - Sorts a scratch copy once and reuses it until setData() is called.
+     * @return Element as <initalized data type>
+     * - Returns -1 if element is out of range.
+     */
+    T getSortedElement(int element);
+
+    /**
+     * @brief Counts the number of outliers.
+     * @param deviations An integer value of standard deviations from mean. Default = 2.
+     * @return Outlier count as an integer.
+     */
+    int getOutliers(int8_t deviations = 2) const;
+
+    /**
+     * @brief Counts the number of beginning elements that are outliers.
+     * - Same as VectorStats::getLeftSkew(). Both walk from the oldest element, like getSlope().
+     * @param deviations An integer value of standard deviations from mean. Default = 2.
+     * @return Skew count of left elements deviating from right mean as an integer.
+     */
+    int getLeftSkew(int8_t deviations = 2) const;
+
+    /**
+     * @brief Calculates slope using linear regression.
+     * - x values are sequence from 1 to size with the oldest element first.
+     * @return Slope as the policy Result type. Can be negative. NaN for fewer than 2 elements.
+     */
+    Result getSlope() const;
+
+    /**
+     * @brief Calculates every statistic at once.
+     * @param deviations An integer value of standard deviations from mean. Default = 2.
+     * @return VectorStatsSummary with mean, std_dev, min, max, slope, outliers and left_skew.
+     */
+    VectorStatsSummary<T, Result> getSummary(int8_t deviations = 2) const;
+
+    /**
+     * @brief Exports count, mean, M2, min, max and regression sums of viewed data.
+     * @param x_start x position of the oldest element. Default = 1.
+     * @return VectorStatsMoments of both blocks.
+     */
+    VectorStatsMoments getMoments(double x_start = 1) const;
+
+private:
+    typedef VectorStatsKernels<T> Kernels;
+
+    const T* _first;
+    int _first_size;
+    const T* _second;
+    int _second_size;
+    int _size;
+    int _mid_element;
+    bool _odd_parity;
+    std::vector<T> _scratch;  // Allocated on first use and reused.
+    bool _scratch_sorted;
+    VectorStatsSorter<T> _sorter;
+
+    Accumulator _sum(int start, int end) const;
+    double _sumSquaredDeviations(int start, int end, double center) const;
+    int _leftSkewCount(float mean, float stdDev, int8_t deviations) const;
+    void _fillScratch();
+};
+
+
+////////////////////////////////////////
+// VectorStatsView Class Implementation
+////////////////////////////////////////
+
+template <typename T, typename Policy>
+VectorStatsView<T, Policy>::VectorStatsView(const T* data, int size)
+    : _scratch_sorted(false) {
+    setData(data, size, nullptr, 0);
+}
+
+template <typename T, typename Policy>
+VectorStatsView<T, Policy>::VectorStatsView(const T* first, int first_size, const T* second, int second_size)
+    : _scratch_sorted(false) {
+    setData(first, first_size, second, second_size);
+}
+
+template <typename T, typename Policy>
+void VectorStatsView<T, Policy>::setData(const T* data, int size) {
+    setData(data, size, nullptr, 0);
+}
+
+template <typename T, typename Policy>
+void VectorStatsView<T, Policy>::setData(const T* first, int first_size, const T* second, int second_size) {
+    _first = first;
+    _first_size = first_size;
+    _second = second;
+    _second_size = second_size;
+    _size = first_size + second_size;
+    _mid_element = _size / 2;
+    _odd_parity = _size % 2;
+    _scratch_sorted = false;
+}
+
+template <typename T, typename Policy>
+int VectorStatsView<T, Policy>::size() const {
+    return _size;
+}
+
+// Same nth_element approach as VectorStats, run on the scratch copy.
+template <typename T, typename Policy>
+T VectorStatsView<T, Policy>::getMedian() {
+    if (_size == 0) {
+        return -1;
+    }
+    if (!_scratch_sorted) {
+        _fillScratch();
+        std::nth_element(_scratch.begin(), _scratch.begin() + _mid_element, _scratch.end());
+    }
+    T right_mid = _scratch[_mid_element];
+    if (_odd_parity) {
+        return right_mid;
+    }
+    T left_mid = _scratch_sorted ? _scratch[_mid_element - 1] :
+        *std::max_element(_scratch.begin(), _scratch.begin() + _mid_element);
+    return (left_mid + right_mid) / 2;
+}
+
+template <typename T, typename Policy>
+typename VectorStatsView<T, Policy>::Result VectorStatsView<T, Policy>::getAverage() const {
+    if (_size == 0) {
+        return 0;
+    }
+    return (double)_sum(0, _size) / _size;
+}
+
+template <typename T, typename Policy>
+typename VectorStatsView<T, Policy>::Result VectorStatsView<T, Policy>::getStdDev() const {
+    if (_size == 0) {
+        return 0;
+    }
+    double mean = (double)_sum(0, _size) / _size;
+    double variance = _sumSquaredDeviations(0, _size, mean) / _size;
+    return std::sqrt(variance);
+}
+
+template <typename T, typename Policy>
+T VectorStatsView<T, Policy>::getElement(int element) const {
+    if (element >= 0 && element < _first_size) {
+        return _first[element];
+    } else if (element >= _first_size && element < _size) {
+        return _second[element - _first_size];
+    } else { return -1; }
+}
+
+template <typename T, typename Policy>
+T VectorStatsView<T, Policy>::getSortedElement(int element) {
+    if (!_scratch_sorted) {
+        _fillScratch();
+        _sorter.sort(_scratch.data(), _size);
+        _scratch_sorted = true;
+    }
+
+    if (element >= 0 && element < _size) {
+        return _scratch[element];
+    } else { return -1; }
+}
+
+template <typename T, typename Policy>
+int VectorStatsView<T, Policy>::getOutliers(int8_t deviations) const {
+    Result stdDev = getStdDev();
+    Result mean = getAverage();
+    Result limit = stdDev * deviations;
+    return Kernels::countOutside(_first, _first_size, mean - limit, mean + limit) +
+           Kernels::countOutside(_second, _second_size, mean - limit, mean + limit);
+}
+
+template <typename T, typename Policy>
+int VectorStatsView<T, Policy>::getLeftSkew(int8_t deviations) const {
+    int right_size = _size - _mid_element;
+    if (right_size == 0) {
+        return 0;
+    }
+    float mean = (double)_sum(_mid_element, _size) / right_size;
+    float variance = _sumSquaredDeviations(_mid_element, _size, mean) / right_size;
+    return _leftSkewCount(mean, std::sqrt(variance), deviations);
+}
+
+// The newest block is shifted by the size of the oldest block.
+template <typename T, typename Policy>
+typename VectorStatsView<T, Policy>::Result VectorStatsView<T, Policy>::getSlope() const {
+    // The regression is 0 / 0 without two x values. VectorStats gets the same NaN from its formula.
+    if (_size < 2) {
+        return std::numeric_limits<Result>::quiet_NaN();
+    }
+    double x_avg = (1 + _size) / 2.0;
+    double weighted = Kernels::weightedSum(_first, _first_size) +
+        Kernels::weightedSum(_second, _second_size) + (double)_first_size * (double)_sum(_first_size, _size);
+    double numerator = weighted - x_avg * (double)_sum(0, _size);
+    double denominator = (double)_size * ((double)_size * _size - 1) / 12.0;
+    return numerator / denominator;
+}
+
+template <typename T, typename Policy>
+VectorStatsSummary<T, typename Policy::result_type> VectorStatsView<T, Policy>::getSummary(int8_t deviations) const {
+    VectorStatsSummary<T, Result> summary = VectorStatsSummary<T, Result>();
+    if (_size == 0) {
+        summary.slope = getSlope();
+        return summary;
+    }
+    double mean = (double)_sum(0, _size) / _size;
+    summary.mean = mean;
+    summary.std_dev = std::sqrt(_sumSquaredDeviations(0, _size, mean) / _size);
+
+    T low = getElement(0), high = getElement(0);
+    if (_first_size > 0) Kernels::minMax(_first, _first_size, low, high);
+    if (_second_size > 0) {
+        T second_low = _second[0], second_high = _second[0];
+        Kernels::minMax(_second, _second_size, second_low, second_high);
+        if (second_low < low) low = second_low;
+        if (high < second_high) high = second_high;
+    }
+    summary.min = low;
+    summary.max = high;
+
+    Result limit = summary.std_dev * deviations;
+    summary.outliers = Kernels::countOutside(_first, _first_size, summary.mean - limit, summary.mean + limit) +
+                       Kernels::countOutside(_second, _second_size, summary.mean - limit, summary.mean + limit);
+    summary.slope = getSlope();
+    summary.left_skew = getLeftSkew(deviations);
+    return summary;
+}
+
+template <typename T, typename Policy>
+VectorStatsMoments VectorStatsView<T, Policy>::getMoments(double x_start) const {
+    VectorStatsMoments moments = VectorStatsMoments::fromData(_first, _first_size, x_start);
+    moments.merge(VectorStatsMoments::fromData(_second, _second_size, x_start + _first_size));
+    return moments;
+}
+
+// Range [start, end) in viewed order split across the two blocks.
+template <typename T, typename Policy>
+typename VectorStatsView<T, Policy>::Accumulator VectorStatsView<T, Policy>::_sum(int start, int end) const {
+    Accumulator total = 0;
+    if (start < _first_size) {
+        total += Policy::sum(_first + start, std::min(end, _first_size) - start);
+    }
+    if (end > _first_size) {
+        int second_start = std::max(start - _first_size, 0);
+        total += Policy::sum(_second + second_start, end - _first_size - second_start);
+    }
+    return total;
+}
+
+template <typename T, typename Policy>
+double VectorStatsView<T, Policy>::_sumSquaredDeviations(int start, int end, double center) const {
+    double total = 0.0;
+    if (start < _first_size) {
+        total += Kernels::sumSquaredDeviations(_first + start, std::min(end, _first_size) - start, center);
+    }
+    if (end > _first_size) {
+        int second_start = std::max(start - _first_size, 0);
+        total += Kernels::sumSquaredDeviations(_second + second_start, end - _first_size - second_start, center);
+    }
+    return total;
+}
+
+// Counts leading elements outside of mean +/- (deviations * stdDev).
+// Negative when the leading outliers sit below the mean.
+template <typename T, typename Policy>
+int VectorStatsView<T, Policy>::_leftSkewCount(float mean, float stdDev, int8_t deviations) const {
+    int skew_count = 0;
+    for (int i = 0; i < _size; ++i) {
+        if (std::abs(getElement(i) - mean) > (stdDev * deviations)) {
+            skew_count++;
+        } else if (skew_count > 0) {
+            float skew_mean = (double)_sum(0, skew_count) / skew_count;
+            if (skew_mean < mean) {
+                skew_count *= -1;
+            }
+            break;
+        } else {break;}
+    }
+    return skew_count;
+}
+
+template <typename T, typename Policy>
+void VectorStatsView<T, Policy>::_fillScratch() {
+    _scratch.resize(_size);
+    std::copy(_first, _first + _first_size, _scratch.begin());
+    std::copy(_second, _second + _second_size, _scratch.begin() + _first_size);
+}
+
+
+#endif